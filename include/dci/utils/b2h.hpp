@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <vector>
 #include <array>
+#include <span>
+#include <utility>
 #include "hexEndian.hpp"
 
 namespace dci::utils
@@ -23,6 +25,28 @@ namespace dci::utils
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string API_DCI_UTILS b2h(const void* b, std::size_t bsize, HexEndian he = HexEndian::little);
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для больших буферов: вход режется на куски, которые кодируются на общем пуле потоков.
+    // До serialThreshold байт - обычный однопоточный b2h
+    constexpr std::size_t b2hParallelThreshold = 1024*1024;
+    void API_DCI_UTILS b2hParallel(const void* b, std::size_t bsize, void* h, HexEndian he = HexEndian::little, std::size_t serialThreshold = b2hParallelThreshold);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // пакетное кодирование множества мелких буферов: результаты ложатся подряд в h,
+    // offsets (если задан, items.size()+1 элементов) - начала результатов в h и общий размер в конце
+    using B2hBatchItem = std::pair<const void*, std::size_t>;
+    void API_DCI_UTILS b2hBatch(std::span<const B2hBatchItem> items, void* h, std::size_t* offsets = nullptr, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string API_DCI_UTILS b2hBatch(std::span<const B2hBatchItem> items, std::vector<std::size_t>& offsets, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // count элементов по itemSize байт с шагом stride, i-й результат в h + i*itemSize*2
+    void API_DCI_UTILS b2hBatch(const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, void* h, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string API_DCI_UTILS b2hBatch(const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, HexEndian he = HexEndian::little);
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C = std::uint8_t, class... CC>
     std::string b2h(const std::vector<C, CC...>& b, HexEndian he = HexEndian::little);
@@ -30,6 +54,35 @@ namespace dci::utils
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C = std::uint8_t, std::size_t N>
     std::string b2h(const std::array<C, N>& b, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // дописывают в конец h, не более одного выделения памяти на вызов
+    template <class Traits, class Alloc>
+    void b2h(const void* b, std::size_t bsize, std::basic_string<char, Traits, Alloc>& h, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC, class Traits, class Alloc>
+    void b2h(const std::vector<C, CC...>& b, std::basic_string<char, Traits, Alloc>& h, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, std::size_t N, class Traits, class Alloc>
+    void b2h(const std::array<C, N>& b, std::basic_string<char, Traits, Alloc>& h, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // в буфер фиксированного размера, без выделения памяти
+    template <class C, std::size_t N>
+    void b2h(const std::array<C, N>& b, std::array<char, N*sizeof(C)*2>& h, HexEndian he = HexEndian::little);
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для тестов: число наборов ядер, пригодных на этом процессоре (0 - рабочий, последний -
+    // побайтовый эталон), и b2h/b2hBatch заданным набором
+    std::size_t API_DCI_UTILS b2hVariants();
+    void API_DCI_UTILS b2hVariant(std::size_t variant, const void* b, std::size_t bsize, void* h, HexEndian he);
+    void API_DCI_UTILS b2hBatchVariant(std::size_t variant, std::span<const B2hBatchItem> items, void* h, std::size_t* offsets, HexEndian he);
+    void API_DCI_UTILS b2hBatchVariant(std::size_t variant, const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, void* h, HexEndian he);
 }
 
 #include "b2h.ipp"
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "b2h.hpp"
+#include "hexFixed.hpp"
 //#include <dci/utils/dbg.hpp>
 
 namespace dci::utils
@@ -23,6 +24,58 @@ namespace dci::utils
     template <class C, std::size_t N>
     std::string b2h(const std::array<C, N>& b, HexEndian he)
     {
-        return b2h(b.data(), b.size()*sizeof(C), he);
+        if constexpr(N*sizeof(C) <= details::hexFixedLimit)
+        {
+            std::string h;
+            h.resize(N*sizeof(C)*2);
+            details::b2hFixed<N*sizeof(C)>(static_cast<const std::uint8_t *>(static_cast<const void *>(b.data())), h.data(), he);
+            return h;
+        }
+        else
+        {
+            return b2h(b.data(), b.size()*sizeof(C), he);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Traits, class Alloc>
+    void b2h(const void* b, std::size_t bsize, std::basic_string<char, Traits, Alloc>& h, HexEndian he)
+    {
+        std::size_t hsize = h.size();
+        h.resize(hsize + bsize*2);
+        b2h(b, bsize, h.data() + hsize, he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC, class Traits, class Alloc>
+    void b2h(const std::vector<C, CC...>& b, std::basic_string<char, Traits, Alloc>& h, HexEndian he)
+    {
+        b2h(b.data(), b.size()*sizeof(C), h, he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, std::size_t N, class Traits, class Alloc>
+    void b2h(const std::array<C, N>& b, std::basic_string<char, Traits, Alloc>& h, HexEndian he)
+    {
+        if constexpr(N*sizeof(C) <= details::hexFixedLimit)
+        {
+            std::size_t hsize = h.size();
+            h.resize(hsize + N*sizeof(C)*2);
+            details::b2hFixed<N*sizeof(C)>(static_cast<const std::uint8_t *>(static_cast<const void *>(b.data())), h.data() + hsize, he);
+        }
+        else
+        {
+            b2h(b.data(), b.size()*sizeof(C), h, he);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, std::size_t N>
+    void b2h(const std::array<C, N>& b, std::array<char, N*sizeof(C)*2>& h, HexEndian he)
+    {
+        if constexpr(N*sizeof(C) <= details::hexFixedLimit)
+            details::b2hFixed<N*sizeof(C)>(static_cast<const std::uint8_t *>(static_cast<const void *>(b.data())), h.data(), he);
+        else
+            b2h(b.data(), b.size()*sizeof(C), h.data(), he);
     }
 }
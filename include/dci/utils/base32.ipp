@@ -0,0 +1,68 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "base32.hpp"
+
+namespace dci::utils::base32
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    std::string encode(const std::vector<C, CC...>& b, Alphabet a, bool pad)
+    {
+        return encode(b.data(), b.size()*sizeof(C), a, pad);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, std::size_t N>
+    std::string encode(const std::array<C, N>& b, Alphabet a, bool pad)
+    {
+        return encode(b.data(), b.size()*sizeof(C), a, pad);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    bool decode(const void* t, std::size_t tsize, std::vector<C, CC...>& b, Alphabet a) requires (sizeof(C) == 1)
+    {
+        b.resize(decodedSize(tsize));
+        std::size_t bsize;
+        if(!decode(t, tsize, b.data(), bsize, a))
+        {
+            b.clear();
+            return false;
+        }
+
+        b.resize(bsize);
+        return true;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    bool decode(const char* csz, std::vector<C, CC...>& b, Alphabet a) requires (sizeof(C) == 1)
+    {
+        return decode(csz, strlen(csz), b, a);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    std::vector<C, CC...> decode(const void* t, std::size_t tsize, Alphabet a) requires (sizeof(C) == 1)
+    {
+        std::vector<C, CC...> res;
+        decode(t, tsize, res, a);
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    std::vector<C, CC...> decode(const char* csz, Alphabet a) requires (sizeof(C) == 1)
+    {
+        std::vector<C, CC...> res;
+        decode(csz, res, a);
+        return res;
+    }
+}
@@ -0,0 +1,78 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "api.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace dci::utils::base64
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    enum class Alphabet
+    {
+        standard,   // RFC 4648 §4, "+/"
+        url,        // RFC 4648 §5, "-_"
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS encodedSize(std::size_t bsize, bool pad = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void API_DCI_UTILS encode(const void* b, std::size_t bsize, void* t, Alphabet a = Alphabet::standard, bool pad = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string API_DCI_UTILS encode(const void* b, std::size_t bsize, Alphabet a = Alphabet::standard, bool pad = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, class... CC>
+    std::string encode(const std::vector<C, CC...>& b, Alphabet a = Alphabet::standard, bool pad = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, std::size_t N>
+    std::string encode(const std::array<C, N>& b, Alphabet a = Alphabet::standard, bool pad = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // верхняя граница размера результата decode
+    std::size_t API_DCI_UTILS decodedSize(std::size_t tsize);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // выравнивание '=' допускается но не требуется, bsize - фактический размер результата
+    bool API_DCI_UTILS decode(const void* t, std::size_t tsize, void* b, std::size_t& bsize, Alphabet a = Alphabet::standard);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, class... CC>
+    bool decode(const void* t, std::size_t tsize, std::vector<C, CC...>& b, Alphabet a = Alphabet::standard) requires (sizeof(C) == 1);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, class... CC>
+    bool decode(const char* csz, std::vector<C, CC...>& b, Alphabet a = Alphabet::standard) requires (sizeof(C) == 1);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, class... CC>
+    std::vector<C, CC...> decode(const void* t, std::size_t tsize, Alphabet a = Alphabet::standard) requires (sizeof(C) == 1);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C = std::uint8_t, class... CC>
+    std::vector<C, CC...> decode(const char* csz, Alphabet a = Alphabet::standard) requires (sizeof(C) == 1);
+}
+
+namespace dci::utils::base64::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для тестов: число наборов ядер, пригодных на этом процессоре (0 - рабочий, последний -
+    // скалярный), и encode/decode заданным набором
+    std::size_t API_DCI_UTILS variants();
+    void API_DCI_UTILS encodeVariant(std::size_t variant, const void* b, std::size_t bsize, void* t, Alphabet a, bool pad);
+    bool API_DCI_UTILS decodeVariant(std::size_t variant, const void* t, std::size_t tsize, void* b, std::size_t& bsize, Alphabet a);
+}
+
+#include "base64.ipp"
@@ -0,0 +1,119 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "api.hpp"
+#include "uri.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <type_traits>
+
+namespace dci::utils::uri::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // границы компонент от начала строки, общие для всех видов:
+    //   scheme ":" hierPart [ "?" query ] [ "#" fragment ]
+    //          ^schemeEnd   ^hierEnd      ^queryEnd         ^size
+    // и внутри hierPart:
+    //   "//" [ name [ ":" password ] "@" ] host [ ":" port ] path
+    //                ^nameEnd              ^hostBegin ^hostEnd  ^pathBegin
+    struct CompactLayout
+    {
+        std::uint32_t   _size{};
+        std::uint32_t   _schemeEnd{};
+        std::uint32_t   _hierEnd{};
+        std::uint32_t   _queryEnd{};
+        std::uint32_t   _nameEnd{};
+        std::uint32_t   _hostBegin{};
+        std::uint32_t   _hostEnd{};
+        std::uint32_t   _pathBegin{};
+        Kind            _kind{};
+        HostKind        _hostKind{};
+        bool            _valid{};
+    };
+
+    bool API_DCI_UTILS compactLayout(std::string_view src, CompactLayout& dst);
+}
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Разобранный URI без копий строк и без variant: указатель на исходную строку, смещения
+    // границ компонент в ней и вид. Offset - std::uint16_t (строки до 64К, 32 байта на URI)
+    // или std::uint32_t (48 байт). Исходная строка должна жить, пока используется CompactURI.
+    // Поля доступны под теми же именами, что и в альтернативах URI<String>; поля, которых
+    // у вида нет или которые не разобраны из-за ошибки, пусты
+    template <class Offset = std::uint32_t>
+    class CompactURI
+    {
+        static_assert(std::is_same_v<Offset, std::uint16_t> || std::is_same_v<Offset, std::uint32_t>);
+
+    public:
+        // как uri::parse; false и для строки длиннее, чем адресуется Offset, - тогда вид unknown с пустым содержимым
+        bool parse(std::string_view src);
+
+        // storage получает текстовый вид src, CompactURI ссылается на storage
+        template <class String>
+        bool assign(const URI<String>& src, std::string& storage);
+
+        template <class String = std::string_view>
+        URI<String> toURI() const;
+
+        uri::Kind kind() const;
+        bool valid() const;
+
+        // вся исходная строка (для unknown - Unknown::_content)
+        std::string_view source() const;
+
+        std::string_view scheme() const;
+        std::string_view hierPart() const;
+        std::optional<std::string_view> query() const;
+        std::optional<std::string_view> fragment() const;
+
+        // mailto
+        std::string_view value() const;
+
+        // inproc, local, file
+        std::optional<std::string_view> auth() const;
+
+        // www и производные
+        std::optional<std::string_view> userName() const;
+        std::optional<std::string_view> password() const;
+
+        // tcp, udp и www; host - как uri::host(), для IP-literal без скобок
+        uri::HostKind hostKind() const;
+        std::string_view host() const;
+        std::optional<std::string_view> port() const;
+
+        // file, www
+        std::string_view path() const;
+
+    private:
+        std::string_view part(Offset begin, Offset end) const;
+        bool isNode() const;
+        bool isWww() const;
+
+    private:
+        const char*     _src{};
+        Offset          _size{};
+        Offset          _schemeEnd{};
+        Offset          _hierEnd{};
+        Offset          _queryEnd{};
+        Offset          _nameEnd{};
+        Offset          _hostBegin{};
+        Offset          _hostEnd{};
+        Offset          _pathBegin{};
+        uri::Kind       _kind{};
+        uri::HostKind   _hostKind{};
+        bool            _valid{};
+    };
+}
+
+#include "compactUri.ipp"
@@ -0,0 +1,364 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <limits>
+
+namespace dci::utils::uri::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // приемник для operator<< у URI, дописывает в строку
+    struct StringAppender
+    {
+        std::string& _dst;
+
+        StringAppender& operator<<(std::string_view s)
+        {
+            _dst.append(s);
+            return *this;
+        }
+
+        StringAppender& operator<<(char c)
+        {
+            _dst.push_back(c);
+            return *this;
+        }
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String>
+    std::optional<String> optString(std::optional<std::string_view> src)
+    {
+        if(!src)
+            return {};
+        return String(*src);
+    }
+}
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    bool CompactURI<Offset>::parse(std::string_view src)
+    {
+        *this = CompactURI{};
+
+        if(src.size() > std::numeric_limits<Offset>::max())
+            return false;
+
+        uri::details::CompactLayout layout;
+        bool res = uri::details::compactLayout(src, layout);
+
+        _src        = src.data();
+        _size       = static_cast<Offset>(layout._size);
+        _schemeEnd  = static_cast<Offset>(layout._schemeEnd);
+        _hierEnd    = static_cast<Offset>(layout._hierEnd);
+        _queryEnd   = static_cast<Offset>(layout._queryEnd);
+        _nameEnd    = static_cast<Offset>(layout._nameEnd);
+        _hostBegin  = static_cast<Offset>(layout._hostBegin);
+        _hostEnd    = static_cast<Offset>(layout._hostEnd);
+        _pathBegin  = static_cast<Offset>(layout._pathBegin);
+        _kind       = layout._kind;
+        _hostKind   = layout._hostKind;
+        _valid      = layout._valid;
+
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    template <class String>
+    bool CompactURI<Offset>::assign(const URI<String>& src, std::string& storage)
+    {
+        storage.clear();
+        uri::details::StringAppender out{storage};
+        out << src;
+        return parse(storage);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    template <class String>
+    URI<String> CompactURI<Offset>::toURI() const
+    {
+        using namespace uri;
+
+        auto genericAlt = [&]<class Alt>(Alt&& alt) -> URI<String>
+        {
+            alt._scheme = String(scheme());
+            alt._hierPart = String(hierPart());
+            alt._query = uri::details::optString<String>(query());
+            alt._fragment = uri::details::optString<String>(fragment());
+            return std::move(alt);
+        };
+
+        auto mkHost = [&]() -> networkNode::Host<String>
+        {
+            switch(_hostKind)
+            {
+            case HostKind::ip4:         return networkNode::Ip4<String>{String(host())};
+            case HostKind::ip6:         return networkNode::Ip6<String>{String(host())};
+            case HostKind::ipFuture:    return networkNode::IpFuture<String>{String(host())};
+            case HostKind::regName:     break;
+            }
+            return networkNode::RegName<String>{String(host())};
+        };
+
+        auto nodeAlt = [&]<class Alt>(Alt&& alt) -> URI<String>
+        {
+            if(_valid)
+                alt._auth = NetworkNode<String>{mkHost(), uri::details::optString<String>(port())};
+            return genericAlt(std::move(alt));
+        };
+
+        auto wwwAlt = [&]<class Alt>(Alt&& alt) -> URI<String>
+        {
+            if(_valid)
+            {
+                if(std::optional<std::string_view> name = userName())
+                    alt._auth._userinfo = www::Userinfo<String>{String(*name), uri::details::optString<String>(password())};
+                alt._auth._networkNode = NetworkNode<String>{mkHost(), uri::details::optString<String>(port())};
+                alt._path = String(path());
+            }
+            return genericAlt(std::move(alt));
+        };
+
+        switch(_kind)
+        {
+        case Kind::unknown: return Unknown<String>{String(source())};
+        case Kind::generic: return genericAlt(Generic<String>{});
+        case Kind::mailto:
+            {
+                Mailto<String> alt;
+                if(_valid)
+                    alt._value = String(value());
+                return genericAlt(std::move(alt));
+            }
+        case Kind::inproc:
+            {
+                Inproc<String> alt;
+                if(_valid)
+                    alt._auth = String(*auth());
+                return genericAlt(std::move(alt));
+            }
+        case Kind::local:
+            {
+                Local<String> alt;
+                if(_valid)
+                    alt._auth = String(*auth());
+                return genericAlt(std::move(alt));
+            }
+        case Kind::file:
+            {
+                File<String> alt;
+                if(_valid)
+                {
+                    alt._auth = uri::details::optString<String>(auth());
+                    alt._path = String(path());
+                }
+                return genericAlt(std::move(alt));
+            }
+        case Kind::tcp:     return nodeAlt(TCP<String>{});
+        case Kind::tcp4:    return nodeAlt(TCP4<String>{});
+        case Kind::tcp6:    return nodeAlt(TCP6<String>{});
+        case Kind::udp:     return nodeAlt(UDP<String>{});
+        case Kind::udp4:    return nodeAlt(UDP4<String>{});
+        case Kind::udp6:    return nodeAlt(UDP6<String>{});
+        case Kind::www:     return wwwAlt(WWW<String>{});
+        case Kind::http:    return wwwAlt(HTTP<String>{});
+        case Kind::https:   return wwwAlt(HTTPS<String>{});
+        case Kind::ftp:     return wwwAlt(FTP<String>{});
+        case Kind::ftps:    return wwwAlt(FTPS<String>{});
+        }
+
+        return Unknown<String>{};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    uri::Kind CompactURI<Offset>::kind() const
+    {
+        return _kind;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    bool CompactURI<Offset>::valid() const
+    {
+        return _valid;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::source() const
+    {
+        return part(0, _size);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::scheme() const
+    {
+        if(uri::Kind::unknown == _kind)
+            return {};
+        return part(0, _schemeEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::hierPart() const
+    {
+        if(uri::Kind::unknown == _kind)
+            return {};
+        return part(static_cast<Offset>(_schemeEnd + 1), _hierEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::query() const
+    {
+        if(uri::Kind::unknown == _kind || _hierEnd == _size || '?' != _src[_hierEnd])
+            return {};
+        return part(static_cast<Offset>(_hierEnd + 1), _queryEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::fragment() const
+    {
+        if(uri::Kind::unknown == _kind || _queryEnd == _size)
+            return {};
+        return part(static_cast<Offset>(_queryEnd + 1), _size);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::value() const
+    {
+        if(uri::Kind::mailto != _kind)
+            return {};
+        return hierPart();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::auth() const
+    {
+        if(!_valid)
+            return {};
+
+        switch(_kind)
+        {
+        case uri::Kind::inproc:
+        case uri::Kind::local:
+            return part(static_cast<Offset>(_schemeEnd + 3), _hierEnd);
+
+        case uri::Kind::file:
+            if(_hostBegin == _hostEnd)
+                return {};
+            return part(_hostBegin, _hostEnd);
+
+        default:
+            return {};
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::userName() const
+    {
+        if(!_valid || !isWww() || _hostBegin == _schemeEnd + 3)
+            return {};
+        return part(static_cast<Offset>(_schemeEnd + 3), _nameEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::password() const
+    {
+        // _hostBegin - 1 - это '@'
+        if(!userName() || _nameEnd + 1 == _hostBegin)
+            return {};
+        return part(static_cast<Offset>(_nameEnd + 1), static_cast<Offset>(_hostBegin - 1));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    uri::HostKind CompactURI<Offset>::hostKind() const
+    {
+        return _hostKind;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::host() const
+    {
+        if(!_valid)
+            return {};
+
+        if(uri::Kind::file == _kind)
+            return auth().value_or(std::string_view{});
+
+        if(!isNode() && !isWww())
+            return {};
+
+        if(uri::HostKind::ip6 == _hostKind || uri::HostKind::ipFuture == _hostKind)
+            return part(static_cast<Offset>(_hostBegin + 1), static_cast<Offset>(_hostEnd - 1));
+
+        return part(_hostBegin, _hostEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::optional<std::string_view> CompactURI<Offset>::port() const
+    {
+        if(!_valid)
+            return {};
+
+        Offset end;
+        if(isNode())
+            end = _hierEnd;
+        else if(isWww())
+            end = _pathBegin;
+        else
+            return {};
+
+        if(_hostEnd == end)
+            return {};
+        return part(static_cast<Offset>(_hostEnd + 1), end);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::path() const
+    {
+        if(!_valid || (uri::Kind::file != _kind && !isWww()))
+            return {};
+        return part(_pathBegin, _hierEnd);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    std::string_view CompactURI<Offset>::part(Offset begin, Offset end) const
+    {
+        return {_src + begin, static_cast<std::size_t>(end - begin)};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    bool CompactURI<Offset>::isNode() const
+    {
+        return _kind >= uri::Kind::tcp && _kind <= uri::Kind::udp6;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Offset>
+    bool CompactURI<Offset>::isWww() const
+    {
+        return _kind >= uri::Kind::www && _kind <= uri::Kind::ftps;
+    }
+}
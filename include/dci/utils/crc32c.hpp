@@ -0,0 +1,49 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include "api.hpp"
+#include <cstdint>
+#include <cstddef>
+
+namespace dci::utils
+{
+    // CRC-32C (Castagnoli, полином 0x1EDC6F41, как в iSCSI/ext4/SCTP), для контроля целостности.
+    // crc - результат для предшествующих данных, crc32c(ab) == crc32c(b, crc32c(a))
+    std::uint32_t API_DCI_UTILS crc32c(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+    template <class Container>
+    std::uint32_t crc32c(const Container& material, std::uint32_t crc = 0) requires requires {material.data(); material.size();};
+
+    // инкрементальное вычисление: update по частям, digest равен crc32c от всего материала сразу
+    class Crc32c
+    {
+    public:
+        Crc32c() = default;
+
+        Crc32c& update(const void* data, std::size_t size);
+
+        template <class Container>
+        Crc32c& update(const Container& material);
+
+        std::uint32_t digest() const;
+        void reset();
+
+    private:
+        std::uint32_t _crc{};
+    };
+}
+
+namespace dci::utils::details
+{
+    // для тестов: число ядер, пригодных на этом процессоре (0 - рабочее, последнее - табличное),
+    // и crc32c заданным ядром
+    std::size_t API_DCI_UTILS crc32cVariants();
+    std::uint32_t API_DCI_UTILS crc32cVariant(std::size_t variant, const void* data, std::size_t size, std::uint32_t crc = 0);
+}
+
+#include "crc32c.ipp"
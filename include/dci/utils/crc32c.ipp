@@ -0,0 +1,41 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <cstdint>
+
+namespace dci::utils
+{
+    template <class Container>
+    std::uint32_t crc32c(const Container& material, std::uint32_t crc) requires requires {material.data(); material.size();}
+    {
+        return crc32c(material.data(), material.size() * sizeof(*material.data()), crc);
+    }
+
+    inline Crc32c& Crc32c::update(const void* data, std::size_t size)
+    {
+        _crc = crc32c(data, size, _crc);
+        return *this;
+    }
+
+    template <class Container>
+    Crc32c& Crc32c::update(const Container& material)
+    {
+        _crc = crc32c(material, _crc);
+        return *this;
+    }
+
+    inline std::uint32_t Crc32c::digest() const
+    {
+        return _crc;
+    }
+
+    inline void Crc32c::reset()
+    {
+        _crc = 0;
+    }
+}
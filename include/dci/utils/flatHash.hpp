@@ -0,0 +1,251 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "fnv1a.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // хеш по умолчанию для FlatMap/FlatSet: строки (и все что приводится к std::string_view) - fnv1a от символов,
+    // так что std::string, std::string_view и литералы дают одно значение и допускают поиск друг по другу
+    struct FlatHash
+    {
+        using is_transparent = void;
+
+        std::uint64_t operator()(std::string_view key) const;
+
+        template <class T>
+        std::uint64_t operator()(const T& key) const requires (!std::is_convertible_v<const T&, std::string_view>);
+    };
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Hash, class Equal>
+    concept FlatTransparent = requires
+    {
+        typename Hash::is_transparent;
+        typename Equal::is_transparent;
+    };
+
+    // поиск по K без приведения к Key - только между строками: у прочих типов std::equal_to<> и хеш
+    // расходятся (0xFFFFFFFFu == -1, но хеши разные; float и double хешируются разными std::hash)
+    template <class Hash, class Equal, class Key, class K>
+    concept FlatHeterogeneous = std::is_same_v<K, Key> ||
+                                (FlatTransparent<Hash, Equal> &&
+                                 std::is_convertible_v<const K&, std::string_view> &&
+                                 std::is_convertible_v<const Key&, std::string_view>);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value>
+    struct FlatMapPolicy;
+
+    template <class Key>
+    struct FlatSetPolicy;
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Открытая адресация в духе SwissTable: на каждый слот байт управления (пусто/удален/7 бит хеша),
+    // при поиске группа из 16 (SSE2) или 8 (SWAR) байт управления сравнивается с 7 битами хеша разом,
+    // ключи сравниваются только у совпавших слотов. Слоты лежат одним массивом, без узлов.
+    template <class Policy, class Hash, class Equal, class Alloc>
+    class FlatTable
+    {
+    public:
+        using key_type          = typename Policy::Key;
+        using value_type        = typename Policy::Slot;
+        using size_type         = std::size_t;
+        using difference_type   = std::ptrdiff_t;
+        using hasher            = Hash;
+        using key_equal         = Equal;
+        using allocator_type    = Alloc;
+
+    private:
+        template <bool isConst>
+        class Iterator;
+
+    public:
+        using iterator          = Iterator<Policy::_constIterator>;
+        using const_iterator    = Iterator<true>;
+
+    public:
+        FlatTable();
+        explicit FlatTable(size_type reserve, const Hash& hash = Hash{}, const Equal& equal = Equal{}, const Alloc& alloc = Alloc{});
+        FlatTable(std::initializer_list<value_type> values, size_type reserve = 0, const Hash& hash = Hash{}, const Equal& equal = Equal{}, const Alloc& alloc = Alloc{});
+        FlatTable(const FlatTable& from);
+        FlatTable(FlatTable&& from) noexcept;
+        ~FlatTable();
+
+        FlatTable& operator=(const FlatTable& from);
+        FlatTable& operator=(FlatTable&& from) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                                                         std::allocator_traits<Alloc>::is_always_equal::value);
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        bool empty() const;
+        size_type size() const;
+        size_type capacity() const;
+        float load_factor() const;
+        static constexpr float max_load_factor();
+
+        void clear();
+
+        // reserve(n) - n элементов вставляются без перестроения таблицы
+        void reserve(size_type count);
+
+        // перестроение под max(count, size()) элементов, в том числе с уменьшением и сбросом удаленных слотов
+        void rehash(size_type count);
+
+        std::pair<iterator, bool> insert(const value_type& value);
+        std::pair<iterator, bool> insert(value_type&& value);
+
+        template <class InputIt>
+        void insert(InputIt first, InputIt last);
+        void insert(std::initializer_list<value_type> values);
+
+        template <class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args);
+
+        // строковые K ищутся без временного key_type, если Hash и Equal прозрачные (как FlatHash и std::equal_to<>),
+        // остальные K сначала приводятся к key_type
+        template <class K = key_type>
+        iterator find(const K& key);
+
+        template <class K = key_type>
+        const_iterator find(const K& key) const;
+
+        template <class K = key_type>
+        bool contains(const K& key) const;
+
+        template <class K = key_type>
+        size_type count(const K& key) const;
+
+        template <class K = key_type>
+        size_type erase(const K& key) requires (!std::is_convertible_v<const K&, const_iterator>);
+
+        iterator erase(const_iterator pos);
+
+        void swap(FlatTable& other) noexcept;
+
+        hasher hash_function() const;
+        key_equal key_eq() const;
+        allocator_type get_allocator() const;
+
+    protected:
+        template <class K, class... Args>
+        std::pair<iterator, bool> tryEmplace(K&& key, Args&&... args);
+
+    private:
+        using CtrlAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::int8_t>;
+        using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+        using SlotTraits = std::allocator_traits<SlotAlloc>;
+
+        template <class K>
+        std::uint64_t hashOf(const K& key) const;
+
+        // ключ другого типа здесь всегда строковый (см. FlatHeterogeneous), сравнивается как std::string_view -
+        // у строк с разными аллокаторами нет общего operator==
+        template <class K>
+        static decltype(auto) probeKey(const K& key);
+
+        template <class K>
+        size_type findIndex(const K& key, std::uint64_t hash) const;
+
+        size_type prepareInsert(std::uint64_t hash);
+        size_type findNonFull(std::uint64_t hash) const;
+        void setCtrl(size_type index, std::int8_t ctrl);
+        void eraseIndex(size_type index);
+
+        // забирает буферы from, освобождать их должен уже _alloc (или аллокатор from, если withAlloc)
+        template <bool withAlloc>
+        void adopt(FlatTable& from);
+
+        void resize(size_type capacity);
+        void destroySlots();
+        void deallocate();
+
+        static size_type capacityToGrowth(size_type capacity);
+        static size_type growthToCapacity(size_type growth);
+
+    private:
+        [[no_unique_address]] Hash      _hash;
+        [[no_unique_address]] Equal     _equal;
+        [[no_unique_address]] SlotAlloc _alloc;
+
+        std::int8_t*    _ctrl{};
+        value_type*     _slots{};
+        size_type       _capacity{};
+        size_type       _size{};
+        size_type       _growthLeft{};
+    };
+}
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Хранит std::pair<Key, Value> (а не pair<const Key, Value>, чтобы элементы перемещались при росте таблицы);
+    // ключ у найденного элемента менять нельзя.
+    // Итераторы и ссылки на элементы недействительны после вставки, вызвавшей рост таблицы, и после rehash.
+    template <class Key, class Value, class Hash = FlatHash, class Equal = std::equal_to<>, class Alloc = std::allocator<std::pair<Key, Value>>>
+    class FlatMap
+        : public details::FlatTable<details::FlatMapPolicy<Key, Value>, Hash, Equal, Alloc>
+    {
+        using Base = details::FlatTable<details::FlatMapPolicy<Key, Value>, Hash, Equal, Alloc>;
+
+    public:
+        using mapped_type = Value;
+        using typename Base::iterator;
+        using typename Base::const_iterator;
+
+        using Base::Base;
+
+        template <class K>
+        Value& operator[](K&& key);
+
+        template <class K>
+        Value& at(const K& key);
+
+        template <class K>
+        const Value& at(const K& key) const;
+
+        template <class K, class... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args);
+
+        template <class K, class M>
+        std::pair<iterator, bool> insert_or_assign(K&& key, M&& value);
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Hash = FlatHash, class Equal = std::equal_to<>, class Alloc = std::allocator<Key>>
+    class FlatSet
+        : public details::FlatTable<details::FlatSetPolicy<Key>, Hash, Equal, Alloc>
+    {
+        using Base = details::FlatTable<details::FlatSetPolicy<Key>, Hash, Equal, Alloc>;
+
+    public:
+        using Base::Base;
+    };
+}
+
+#include "flatHash.ipp"
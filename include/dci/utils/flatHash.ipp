@@ -0,0 +1,956 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "flatHash.hpp"
+#include "wyhash.hpp"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline std::uint64_t FlatHash::operator()(std::string_view key) const
+    {
+        return fnv1a(key.data(), key.size());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class T>
+    std::uint64_t FlatHash::operator()(const T& key) const requires (!std::is_convertible_v<const T&, std::string_view>)
+    {
+        if constexpr(std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            // через 64 бита, чтобы int и long с равными значениями находили друг друга
+            std::uint64_t v = static_cast<std::uint64_t>(key);
+            return fnv1a(reinterpret_cast<const unsigned char*>(&v), sizeof(v));
+        }
+        else if constexpr(std::has_unique_object_representations_v<T>)
+        {
+            return fnv1a(reinterpret_cast<const unsigned char*>(&key), sizeof(T));
+        }
+        else
+        {
+            return std::hash<T>{}(key);
+        }
+    }
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // байт управления: >= 0 - занят, младшие 7 бит хеша; иначе пусто/удален
+    constexpr std::int8_t flatEmpty     = -128;
+    constexpr std::int8_t flatDeleted   = -2;
+
+#if defined(__SSE2__)
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    struct FlatGroup
+    {
+        static constexpr std::size_t _width = 16;
+
+        explicit FlatGroup(const std::int8_t* ctrl)
+            : _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))}
+        {
+        }
+
+        // маски, бит i - байт i группы
+        std::uint32_t match(std::int8_t h2) const
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+        }
+
+        std::uint32_t matchEmpty() const
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(flatEmpty), _ctrl)));
+        }
+
+        std::uint32_t matchEmptyOrDeleted() const
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl)));
+        }
+
+        static std::size_t first(std::uint32_t mask)
+        {
+            return static_cast<std::size_t>(std::countr_zero(mask));
+        }
+
+        // число неотмеченных байт в конце группы (для first - в начале)
+        static std::size_t leading(std::uint32_t mask)
+        {
+            return static_cast<std::size_t>(std::countl_zero(mask)) - (32 - _width);
+        }
+
+        __m128i _ctrl;
+    };
+#else
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // переносимый вариант, 8 байт в 64-битном слове; у match возможны ложные срабатывания
+    // только на занятых слотах (байт h2^1 сразу после совпавшего), их отсеивает сравнение ключей
+    struct FlatGroup
+    {
+        static constexpr std::size_t _width = 8;
+        static constexpr std::uint64_t _lsbs = 0x0101010101010101ull;
+        static constexpr std::uint64_t _msbs = 0x8080808080808080ull;
+
+        explicit FlatGroup(const std::int8_t* ctrl)
+        {
+            _ctrl = 0;
+            for(std::size_t i{0}; i<_width; ++i)
+                _ctrl |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(ctrl[i])) << (i*8);
+        }
+
+        std::uint64_t match(std::int8_t h2) const
+        {
+            std::uint64_t x = _ctrl ^ (_lsbs * static_cast<std::uint8_t>(h2));
+            return (x - _lsbs) & ~x & _msbs;
+        }
+
+        std::uint64_t matchEmpty() const
+        {
+            return _ctrl & (~_ctrl << 6) & _msbs;
+        }
+
+        std::uint64_t matchEmptyOrDeleted() const
+        {
+            return _ctrl & (~_ctrl << 7) & _msbs;
+        }
+
+        static std::size_t first(std::uint64_t mask)
+        {
+            return static_cast<std::size_t>(std::countr_zero(mask)) / 8;
+        }
+
+        static std::size_t leading(std::uint64_t mask)
+        {
+            return static_cast<std::size_t>(std::countl_zero(mask)) / 8;
+        }
+
+        std::uint64_t _ctrl;
+    };
+#endif
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class TKey, class Value>
+    struct FlatMapPolicy
+    {
+        using Key = TKey;
+        using Slot = std::pair<Key, Value>;
+        static constexpr bool _constIterator = false;
+
+        static const Key& key(const Slot& slot)
+        {
+            return slot.first;
+        }
+
+        template <class Alloc, class K, class... Args>
+        static void construct(Alloc& alloc, Slot* slot, K&& key, Args&&... args)
+        {
+            std::allocator_traits<Alloc>::construct(alloc, slot, std::piecewise_construct,
+                                                    std::forward_as_tuple(std::forward<K>(key)),
+                                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class TKey>
+    struct FlatSetPolicy
+    {
+        using Key = TKey;
+        using Slot = Key;
+        static constexpr bool _constIterator = true;
+
+        static const Key& key(const Slot& slot)
+        {
+            return slot;
+        }
+
+        template <class Alloc, class K>
+        static void construct(Alloc& alloc, Slot* slot, K&& key)
+        {
+            std::allocator_traits<Alloc>::construct(alloc, slot, std::forward<K>(key));
+        }
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <bool isConst>
+    class FlatTable<Policy, Hash, Equal, Alloc>::Iterator
+    {
+        friend class FlatTable;
+        using Slot = std::conditional_t<isConst, const typename FlatTable::value_type, typename FlatTable::value_type>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename FlatTable::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Slot*;
+        using reference         = Slot&;
+
+        Iterator() = default;
+
+        template <bool otherConst>
+        Iterator(const Iterator<otherConst>& other) requires (isConst && !otherConst)
+            : _ctrl{other._ctrl}
+            , _ctrlEnd{other._ctrlEnd}
+            , _slot{other._slot}
+        {
+        }
+
+        reference operator*() const
+        {
+            return *_slot;
+        }
+
+        pointer operator->() const
+        {
+            return _slot;
+        }
+
+        Iterator& operator++()
+        {
+            ++_ctrl;
+            ++_slot;
+            skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator res = *this;
+            ++*this;
+            return res;
+        }
+
+        template <bool otherConst>
+        bool operator==(const Iterator<otherConst>& other) const
+        {
+            return _slot == other._slot;
+        }
+
+    private:
+        template <bool>
+        friend class Iterator;
+
+        Iterator(const std::int8_t* ctrl, const std::int8_t* ctrlEnd, Slot* slot)
+            : _ctrl{ctrl}
+            , _ctrlEnd{ctrlEnd}
+            , _slot{slot}
+        {
+        }
+
+        void skipFree()
+        {
+            while(_ctrl != _ctrlEnd && *_ctrl < 0)
+            {
+                ++_ctrl;
+                ++_slot;
+            }
+        }
+
+        const std::int8_t*  _ctrl{};
+        const std::int8_t*  _ctrlEnd{};
+        Slot*               _slot{};
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::FlatTable()
+    {
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::FlatTable(size_type reserve, const Hash& hash, const Equal& equal, const Alloc& alloc)
+        : _hash{hash}
+        , _equal{equal}
+        , _alloc{alloc}
+    {
+        this->reserve(reserve);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::FlatTable(std::initializer_list<value_type> values, size_type reserve, const Hash& hash, const Equal& equal, const Alloc& alloc)
+        : FlatTable{std::max(reserve, values.size()), hash, equal, alloc}
+    {
+        insert(values);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::FlatTable(const FlatTable& from)
+        : FlatTable{from.size(), from._hash, from._equal, SlotTraits::select_on_container_copy_construction(from._alloc)}
+    {
+        insert(from.begin(), from.end());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::FlatTable(FlatTable&& from) noexcept
+        : _hash{std::move(from._hash)}
+        , _equal{std::move(from._equal)}
+        , _alloc{std::move(from._alloc)}
+        , _ctrl{std::exchange(from._ctrl, nullptr)}
+        , _slots{std::exchange(from._slots, nullptr)}
+        , _capacity{std::exchange(from._capacity, 0)}
+        , _size{std::exchange(from._size, 0)}
+        , _growthLeft{std::exchange(from._growthLeft, 0)}
+    {
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>::~FlatTable()
+    {
+        destroySlots();
+        deallocate();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>& FlatTable<Policy, Hash, Equal, Alloc>::operator=(const FlatTable& from)
+    {
+        if(this != &from)
+        {
+            constexpr bool propagate = SlotTraits::propagate_on_container_copy_assignment::value;
+
+            // копия строится сразу в памяти того аллокатора, который останется у this
+            FlatTable tmp{from.size(), from._hash, from._equal, Alloc{propagate ? from._alloc : _alloc}};
+            tmp.insert(from.begin(), from.end());
+            adopt<propagate>(tmp);
+        }
+        return *this;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    FlatTable<Policy, Hash, Equal, Alloc>& FlatTable<Policy, Hash, Equal, Alloc>::operator=(FlatTable&& from) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                                                                                                                   std::allocator_traits<Alloc>::is_always_equal::value)
+    {
+        if(this != &from)
+        {
+            if constexpr(SlotTraits::propagate_on_container_move_assignment::value)
+                adopt<true>(from);
+            else if constexpr(SlotTraits::is_always_equal::value)
+                adopt<false>(from);
+            else if(_alloc == from._alloc)
+                adopt<false>(from);
+            else
+            {
+                // буферы from чужие для _alloc - элементы переносятся поштучно
+                FlatTable tmp{from.size(), from._hash, from._equal, Alloc{_alloc}};
+                for(size_type i{0}; i<from._capacity; ++i)
+                    if(from._ctrl[i] >= 0)
+                        tmp.insert(std::move(from._slots[i]));
+                from.clear();
+                adopt<false>(tmp);
+            }
+        }
+        return *this;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::iterator FlatTable<Policy, Hash, Equal, Alloc>::begin()
+    {
+        iterator res{_ctrl, _ctrl + _capacity, _slots};
+        res.skipFree();
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::iterator FlatTable<Policy, Hash, Equal, Alloc>::end()
+    {
+        return iterator{_ctrl + _capacity, _ctrl + _capacity, _slots + _capacity};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::const_iterator FlatTable<Policy, Hash, Equal, Alloc>::begin() const
+    {
+        const_iterator res{_ctrl, _ctrl + _capacity, _slots};
+        res.skipFree();
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::const_iterator FlatTable<Policy, Hash, Equal, Alloc>::end() const
+    {
+        return const_iterator{_ctrl + _capacity, _ctrl + _capacity, _slots + _capacity};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::const_iterator FlatTable<Policy, Hash, Equal, Alloc>::cbegin() const
+    {
+        return begin();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::const_iterator FlatTable<Policy, Hash, Equal, Alloc>::cend() const
+    {
+        return end();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    bool FlatTable<Policy, Hash, Equal, Alloc>::empty() const
+    {
+        return !_size;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::size() const
+    {
+        return _size;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::capacity() const
+    {
+        return _capacity;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    float FlatTable<Policy, Hash, Equal, Alloc>::load_factor() const
+    {
+        return _capacity ? static_cast<float>(_size) / static_cast<float>(_capacity) : 0.0f;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    constexpr float FlatTable<Policy, Hash, Equal, Alloc>::max_load_factor()
+    {
+        return 7.0f / 8.0f;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::clear()
+    {
+        destroySlots();
+        if(_capacity)
+        {
+            std::memset(_ctrl, flatEmpty, _capacity + FlatGroup::_width - 1);
+            _growthLeft = capacityToGrowth(_capacity);
+        }
+        _size = 0;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::reserve(size_type count)
+    {
+        if(count > _size + _growthLeft)
+            resize(growthToCapacity(count));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::rehash(size_type count)
+    {
+        count = std::max(count, _size);
+        if(!count)
+        {
+            destroySlots();
+            deallocate();
+            _size = 0;
+            return;
+        }
+
+        resize(growthToCapacity(count));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    std::pair<typename FlatTable<Policy, Hash, Equal, Alloc>::iterator, bool> FlatTable<Policy, Hash, Equal, Alloc>::insert(const value_type& value)
+    {
+        return tryEmplace(Policy::key(value), value);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    std::pair<typename FlatTable<Policy, Hash, Equal, Alloc>::iterator, bool> FlatTable<Policy, Hash, Equal, Alloc>::insert(value_type&& value)
+    {
+        std::uint64_t hash = hashOf(Policy::key(value));
+        size_type index = findIndex(Policy::key(value), hash);
+        bool inserted = index == _capacity;
+
+        if(inserted)
+        {
+            index = prepareInsert(hash);
+            SlotTraits::construct(_alloc, _slots + index, std::move(value));
+        }
+
+        return {iterator{_ctrl + index, _ctrl + _capacity, _slots + index}, inserted};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class InputIt>
+    void FlatTable<Policy, Hash, Equal, Alloc>::insert(InputIt first, InputIt last)
+    {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            reserve(_size + static_cast<size_type>(std::distance(first, last)));
+
+        for(; first != last; ++first)
+            insert(*first);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::insert(std::initializer_list<value_type> values)
+    {
+        insert(values.begin(), values.end());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class... Args>
+    std::pair<typename FlatTable<Policy, Hash, Equal, Alloc>::iterator, bool> FlatTable<Policy, Hash, Equal, Alloc>::emplace(Args&&... args)
+    {
+        // ключ становится известен только после конструирования элемента
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::iterator FlatTable<Policy, Hash, Equal, Alloc>::find(const K& key)
+    {
+        if constexpr(!FlatHeterogeneous<Hash, Equal, key_type, K>)
+            return find(key_type(key));
+        else
+        {
+            size_type index = findIndex(key, hashOf(key));
+            return iterator{_ctrl + index, _ctrl + _capacity, _slots + index};
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::const_iterator FlatTable<Policy, Hash, Equal, Alloc>::find(const K& key) const
+    {
+        if constexpr(!FlatHeterogeneous<Hash, Equal, key_type, K>)
+            return find(key_type(key));
+        else
+        {
+            size_type index = findIndex(key, hashOf(key));
+            return const_iterator{_ctrl + index, _ctrl + _capacity, _slots + index};
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    bool FlatTable<Policy, Hash, Equal, Alloc>::contains(const K& key) const
+    {
+        if constexpr(!FlatHeterogeneous<Hash, Equal, key_type, K>)
+            return contains(key_type(key));
+        else
+            return findIndex(key, hashOf(key)) != _capacity;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::count(const K& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::erase(const K& key) requires (!std::is_convertible_v<const K&, const_iterator>)
+    {
+        if constexpr(!FlatHeterogeneous<Hash, Equal, key_type, K>)
+            return erase(key_type(key));
+        else
+        {
+            size_type index = findIndex(key, hashOf(key));
+            if(index == _capacity)
+                return 0;
+
+            eraseIndex(index);
+            return 1;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::iterator FlatTable<Policy, Hash, Equal, Alloc>::erase(const_iterator pos)
+    {
+        size_type index = static_cast<size_type>(pos._slot - _slots);
+        eraseIndex(index);
+
+        iterator res{_ctrl + index, _ctrl + _capacity, _slots + index};
+        res.skipFree();
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::swap(FlatTable& other) noexcept
+    {
+        using std::swap;
+        swap(_hash, other._hash);
+        swap(_equal, other._equal);
+        if constexpr(SlotTraits::propagate_on_container_swap::value)
+            swap(_alloc, other._alloc);
+        swap(_ctrl, other._ctrl);
+        swap(_slots, other._slots);
+        swap(_capacity, other._capacity);
+        swap(_size, other._size);
+        swap(_growthLeft, other._growthLeft);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::hasher FlatTable<Policy, Hash, Equal, Alloc>::hash_function() const
+    {
+        return _hash;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::key_equal FlatTable<Policy, Hash, Equal, Alloc>::key_eq() const
+    {
+        return _equal;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::allocator_type FlatTable<Policy, Hash, Equal, Alloc>::get_allocator() const
+    {
+        return allocator_type{_alloc};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K, class... Args>
+    std::pair<typename FlatTable<Policy, Hash, Equal, Alloc>::iterator, bool> FlatTable<Policy, Hash, Equal, Alloc>::tryEmplace(K&& key, Args&&... args)
+    {
+        if constexpr(!FlatHeterogeneous<Hash, Equal, key_type, std::remove_cvref_t<K>>)
+            return tryEmplace(key_type(std::forward<K>(key)), std::forward<Args>(args)...);
+        else
+        {
+            std::uint64_t hash = hashOf(key);
+            size_type index = findIndex(key, hash);
+            bool inserted = index == _capacity;
+
+            if(inserted)
+            {
+                index = prepareInsert(hash);
+                if constexpr(sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, value_type> && ...))
+                    SlotTraits::construct(_alloc, _slots + index, std::forward<Args>(args)...);
+                else
+                    Policy::construct(_alloc, _slots + index, std::forward<K>(key), std::forward<Args>(args)...);
+            }
+
+            return {iterator{_ctrl + index, _ctrl + _capacity, _slots + index}, inserted};
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    std::uint64_t FlatTable<Policy, Hash, Equal, Alloc>::hashOf(const K& key) const
+    {
+        // пользовательский хеш может быть слабым в младших битах (тот же fnv1a у коротких ключей),
+        // 64x64->128 свертка перемешивает все биты; младшие 7 идут в байт управления, остальные в позицию
+        return wyhashMix(static_cast<std::uint64_t>(_hash(key)), 0x9e3779b97f4a7c15ull);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::findIndex(const K& key, std::uint64_t hash) const
+    {
+        if(!_size)
+            return _capacity;
+
+        std::int8_t h2 = static_cast<std::int8_t>(hash & 0x7f);
+        size_type mask = _capacity - 1;
+        size_type pos = static_cast<size_type>(hash >> 7) & mask;
+        decltype(auto) probe = probeKey(key);
+
+        // группы перебираются с шагом 1, 2, 3... групп - при степени двойки обходит всю таблицу
+        for(size_type step{FlatGroup::_width}; ; pos = (pos + step) & mask, step += FlatGroup::_width)
+        {
+            FlatGroup g{_ctrl + pos};
+
+            for(auto m = g.match(h2); m; m &= m - 1)
+            {
+                size_type index = (pos + FlatGroup::first(m)) & mask;
+                if(_equal(Policy::key(_slots[index]), probe))
+                    return index;
+            }
+
+            if(g.matchEmpty())
+                return _capacity;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <class K>
+    decltype(auto) FlatTable<Policy, Hash, Equal, Alloc>::probeKey(const K& key)
+    {
+        if constexpr(std::is_same_v<K, key_type>)
+            return (key);
+        else
+            return std::string_view{key};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::findNonFull(std::uint64_t hash) const
+    {
+        size_type mask = _capacity - 1;
+        size_type pos = static_cast<size_type>(hash >> 7) & mask;
+
+        for(size_type step{FlatGroup::_width}; ; pos = (pos + step) & mask, step += FlatGroup::_width)
+        {
+            auto m = FlatGroup{_ctrl + pos}.matchEmptyOrDeleted();
+            if(m)
+                return (pos + FlatGroup::first(m)) & mask;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::prepareInsert(std::uint64_t hash)
+    {
+        if(!_capacity)
+            resize(growthToCapacity(1));
+
+        size_type index = findNonFull(hash);
+
+        // удаленный слот переиспользуется без расхода запаса роста
+        if(!_growthLeft && flatDeleted != _ctrl[index])
+        {
+            // если таблица забита в основном удаленными слотами - перестроение без роста
+            resize(_size + 1 <= capacityToGrowth(_capacity) / 2 ? _capacity : growthToCapacity(std::max<size_type>(_size + 1, _capacity)));
+            index = findNonFull(hash);
+        }
+
+        if(flatEmpty == _ctrl[index])
+            --_growthLeft;
+
+        setCtrl(index, static_cast<std::int8_t>(hash & 0x7f));
+        ++_size;
+        return index;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::setCtrl(size_type index, std::int8_t ctrl)
+    {
+        _ctrl[index] = ctrl;
+
+        // хвост - копия начала, чтобы группа читалась с любой позиции без перехода через край
+        if(index < FlatGroup::_width - 1)
+            _ctrl[_capacity + index] = ctrl;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::eraseIndex(size_type index)
+    {
+        SlotTraits::destroy(_alloc, _slots + index);
+        --_size;
+
+        // если вокруг слота нет полностью заполненного окна, ни один поиск не мог пройти через него дальше -
+        // слот можно сразу сделать пустым и вернуть в запас роста
+        auto after = FlatGroup{_ctrl + index}.matchEmpty();
+        auto before = FlatGroup{_ctrl + ((index - FlatGroup::_width) & (_capacity - 1))}.matchEmpty();
+
+        bool wasNeverFull = after && before && FlatGroup::first(after) + FlatGroup::leading(before) < FlatGroup::_width;
+
+        if(wasNeverFull)
+        {
+            setCtrl(index, flatEmpty);
+            ++_growthLeft;
+        }
+        else
+        {
+            setCtrl(index, flatDeleted);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    template <bool withAlloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::adopt(FlatTable& from)
+    {
+        destroySlots();
+        deallocate();
+
+        _hash = std::move(from._hash);
+        _equal = std::move(from._equal);
+        if constexpr(withAlloc)
+            _alloc = std::move(from._alloc);
+
+        _ctrl = std::exchange(from._ctrl, nullptr);
+        _slots = std::exchange(from._slots, nullptr);
+        _capacity = std::exchange(from._capacity, 0);
+        _size = std::exchange(from._size, 0);
+        _growthLeft = std::exchange(from._growthLeft, 0);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::resize(size_type capacity)
+    {
+        CtrlAlloc ctrlAlloc{_alloc};
+        std::int8_t* ctrl = std::allocator_traits<CtrlAlloc>::allocate(ctrlAlloc, capacity + FlatGroup::_width - 1);
+        value_type* slots = SlotTraits::allocate(_alloc, capacity);
+        std::memset(ctrl, flatEmpty, capacity + FlatGroup::_width - 1);
+
+        std::int8_t* oldCtrl = _ctrl;
+        value_type* oldSlots = _slots;
+        size_type oldCapacity = _capacity;
+
+        _ctrl = ctrl;
+        _slots = slots;
+        _capacity = capacity;
+        _growthLeft = capacityToGrowth(capacity) - _size;
+
+        for(size_type i{0}; i<oldCapacity; ++i)
+        {
+            if(oldCtrl[i] < 0)
+                continue;
+
+            std::uint64_t hash = hashOf(Policy::key(oldSlots[i]));
+            size_type index = findNonFull(hash);
+            setCtrl(index, static_cast<std::int8_t>(hash & 0x7f));
+
+            SlotTraits::construct(_alloc, slots + index, std::move(oldSlots[i]));
+            SlotTraits::destroy(_alloc, oldSlots + i);
+        }
+
+        if(oldCapacity)
+        {
+            std::allocator_traits<CtrlAlloc>::deallocate(ctrlAlloc, oldCtrl, oldCapacity + FlatGroup::_width - 1);
+            SlotTraits::deallocate(_alloc, oldSlots, oldCapacity);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::destroySlots()
+    {
+        if constexpr(!std::is_trivially_destructible_v<value_type>)
+        {
+            for(size_type i{0}; i<_capacity; ++i)
+                if(_ctrl[i] >= 0)
+                    SlotTraits::destroy(_alloc, _slots + i);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    void FlatTable<Policy, Hash, Equal, Alloc>::deallocate()
+    {
+        if(_capacity)
+        {
+            CtrlAlloc ctrlAlloc{_alloc};
+            std::allocator_traits<CtrlAlloc>::deallocate(ctrlAlloc, _ctrl, _capacity + FlatGroup::_width - 1);
+            SlotTraits::deallocate(_alloc, _slots, _capacity);
+        }
+
+        _ctrl = nullptr;
+        _slots = nullptr;
+        _capacity = 0;
+        _growthLeft = 0;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::capacityToGrowth(size_type capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Policy, class Hash, class Equal, class Alloc>
+    typename FlatTable<Policy, Hash, Equal, Alloc>::size_type FlatTable<Policy, Hash, Equal, Alloc>::growthToCapacity(size_type growth)
+    {
+        size_type capacity = std::bit_ceil(std::max<size_type>(growth + growth / 7, FlatGroup::_width));
+        while(capacityToGrowth(capacity) < growth)
+            capacity *= 2;
+        return capacity;
+    }
+}
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value, class Hash, class Equal, class Alloc>
+    template <class K>
+    Value& FlatMap<Key, Value, Hash, Equal, Alloc>::operator[](K&& key)
+    {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value, class Hash, class Equal, class Alloc>
+    template <class K>
+    Value& FlatMap<Key, Value, Hash, Equal, Alloc>::at(const K& key)
+    {
+        iterator iter = this->find(key);
+        if(this->end() == iter)
+            throw std::out_of_range("FlatMap::at");
+        return iter->second;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value, class Hash, class Equal, class Alloc>
+    template <class K>
+    const Value& FlatMap<Key, Value, Hash, Equal, Alloc>::at(const K& key) const
+    {
+        const_iterator iter = this->find(key);
+        if(this->end() == iter)
+            throw std::out_of_range("FlatMap::at");
+        return iter->second;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value, class Hash, class Equal, class Alloc>
+    template <class K, class... Args>
+    std::pair<typename FlatMap<Key, Value, Hash, Equal, Alloc>::iterator, bool> FlatMap<Key, Value, Hash, Equal, Alloc>::try_emplace(K&& key, Args&&... args)
+    {
+        return this->tryEmplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Key, class Value, class Hash, class Equal, class Alloc>
+    template <class K, class M>
+    std::pair<typename FlatMap<Key, Value, Hash, Equal, Alloc>::iterator, bool> FlatMap<Key, Value, Hash, Equal, Alloc>::insert_or_assign(K&& key, M&& value)
+    {
+        auto res = this->tryEmplace(std::forward<K>(key), std::forward<M>(value));
+        if(!res.second)
+            res.first->second = std::forward<M>(value);
+        return res;
+    }
+}
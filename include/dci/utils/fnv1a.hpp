@@ -6,7 +6,24 @@
    You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
 
 #pragma once
+#include "api.hpp"
 #include <cstdint>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <array>
+
+namespace dci::utils::details
+{
+    template <class T>
+    concept Fnv1aBuffers = std::ranges::range<T> && std::ranges::range<std::ranges::range_value_t<T>>;
+
+    // для тестов: число ядер fnv1aBatch, пригодных на этом процессоре (0 - рабочее, последнее - без SIMD),
+    // и fnv1aBatch заданным ядром
+    std::size_t API_DCI_UTILS fnv1aBatchVariants();
+    void API_DCI_UTILS fnv1aBatchVariant(std::size_t variant, std::span<const std::string_view> keys, std::uint64_t* digests);
+}
 
 namespace dci::utils
 {
@@ -14,10 +31,44 @@ namespace dci::utils
     constexpr std::uint64_t fnv1a(const Char* material, std::size_t len);
 
     template <class Container>
-    constexpr std::uint64_t fnv1a(const Container& material);
+    constexpr std::uint64_t fnv1a(const Container& material) requires (!details::Fnv1aBuffers<Container>);
 
     template <class LiteralChar, std::size_t N>
     constexpr std::uint64_t fnv1a(const LiteralChar (&material)[N]);
+
+    // набор фрагментов (iovec-подобные части, сегменты rope и т.п.), результат как от их конкатенации
+    template <class Buffers>
+    constexpr std::uint64_t fnv1a(const Buffers& buffers) requires details::Fnv1aBuffers<Buffers>;
+
+    // пакетное вычисление для множества коротких ключей, ключи хешируются параллельно в SIMD-дорожках.
+    // digests[i] == fnv1a(keys[i])
+    void API_DCI_UTILS fnv1aBatch(std::span<const std::string_view> keys, std::uint64_t* digests);
+
+    template <std::size_t N>
+    std::array<std::uint64_t, N> fnv1aBatch(const std::array<std::string_view, N>& keys);
+
+    // инкрементальное вычисление: update по частям, digest равен fnv1a от всего материала сразу
+    class Fnv1a
+    {
+    public:
+        static constexpr std::uint64_t _basis = 0xcbf29ce484222325;
+        static constexpr std::uint64_t _prime = 0x100000001b3;
+
+    public:
+        constexpr Fnv1a() = default;
+
+        template <class Char>
+        constexpr Fnv1a& update(const Char* material, std::size_t len);
+
+        template <class Container>
+        constexpr Fnv1a& update(const Container& material);
+
+        constexpr std::uint64_t digest() const;
+        constexpr void reset();
+
+    private:
+        std::uint64_t _state{_basis};
+    };
 }
 
 #include "fnv1a.ipp"
@@ -13,19 +13,11 @@ namespace dci::utils
     template <class Char>
     constexpr std::uint64_t fnv1a(const Char* material, std::size_t len)
     {
-        std::uint64_t result = 0xcbf29ce484222325;
-
-        for(std::size_t i{0}; i<len; ++i)
-        {
-            result ^= static_cast<std::uint64_t>(material[i]);
-            result *= 0x100000001b3;
-        }
-
-        return result;
+        return Fnv1a{}.update(material, len).digest();
     }
 
     template <class Container>
-    constexpr std::uint64_t fnv1a(const Container& material)
+    constexpr std::uint64_t fnv1a(const Container& material) requires (!details::Fnv1aBuffers<Container>)
     {
         return fnv1a(material.data(), material.size());
     }
@@ -36,4 +28,53 @@ namespace dci::utils
         static_assert(N > 0);
         return fnv1a(&material[0], N-1);
     }
+
+    template <class Buffers>
+    constexpr std::uint64_t fnv1a(const Buffers& buffers) requires details::Fnv1aBuffers<Buffers>
+    {
+        Fnv1a hasher;
+        for(const auto& buffer : buffers)
+            hasher.update(buffer);
+
+        return hasher.digest();
+    }
+
+    template <std::size_t N>
+    std::array<std::uint64_t, N> fnv1aBatch(const std::array<std::string_view, N>& keys)
+    {
+        std::array<std::uint64_t, N> digests;
+        fnv1aBatch(std::span<const std::string_view>{keys}, digests.data());
+        return digests;
+    }
+
+    template <class Char>
+    constexpr Fnv1a& Fnv1a::update(const Char* material, std::size_t len)
+    {
+        std::uint64_t state = _state;
+
+        for(std::size_t i{0}; i<len; ++i)
+        {
+            state ^= static_cast<std::uint64_t>(material[i]);
+            state *= _prime;
+        }
+
+        _state = state;
+        return *this;
+    }
+
+    template <class Container>
+    constexpr Fnv1a& Fnv1a::update(const Container& material)
+    {
+        return update(material.data(), material.size());
+    }
+
+    constexpr std::uint64_t Fnv1a::digest() const
+    {
+        return _state;
+    }
+
+    constexpr void Fnv1a::reset()
+    {
+        _state = _basis;
+    }
 }
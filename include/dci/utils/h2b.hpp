@@ -13,6 +13,7 @@
 #include <vector>
 #include <array>
 #include <type_traits>
+#include <string_view>
 #include "hexEndian.hpp"
 
 namespace dci::utils
@@ -20,6 +21,28 @@ namespace dci::utils
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     bool API_DCI_UTILS h2b(const void* h, std::size_t hsize, void* b, HexEndian he = HexEndian::little);
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // badOffset - позиция первого недопустимого символа в h, либо hsize если все символы допустимы
+    bool API_DCI_UTILS h2b(const void* h, std::size_t hsize, void* b, std::size_t& badOffset, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для больших буферов: вход режется на куски, которые декодируются на общем пуле потоков.
+    // До serialThreshold символов - обычный однопоточный h2b
+    constexpr std::size_t h2bParallelThreshold = 2*1024*1024;
+    bool API_DCI_UTILS h2bParallel(const void* h, std::size_t hsize, void* b, HexEndian he = HexEndian::little, std::size_t serialThreshold = h2bParallelThreshold);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // разбор "de:ad:be:ef", "0xDEADBEEF", вывода hexdump и т.п.: символы из separators пропускаются,
+    // перед каждой группой цифр допускается префикс 0x/0X (если allowPrefix).
+    // Цифры декодируются как h2b над ними же без разделителей, b должен вмещать (hsize+1)/2 байт,
+    // bsize - фактический размер результата
+    constexpr std::string_view h2bSeparators = " \t\r\n:-,";
+    bool API_DCI_UTILS h2bSeparated(const void* h, std::size_t hsize, void* b, std::size_t& bsize, HexEndian he = HexEndian::little, std::string_view separators = h2bSeparators, bool allowPrefix = true);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    bool h2bSeparated(std::string_view h, std::vector<C, CC...>& b, HexEndian he = HexEndian::little, std::string_view separators = h2bSeparators, bool allowPrefix = true) requires (sizeof(C) == 1);
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C, class... CC>
     bool h2b(const void* h, std::size_t hsize, std::vector<C, CC...>& b, HexEndian he = HexEndian::little) requires std::is_standard_layout_v<C>;
@@ -27,7 +50,7 @@ namespace dci::utils
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C, class... CC>
     bool h2b(const char* csz, std::vector<C, CC...>& b, HexEndian he = HexEndian::little) requires std::is_standard_layout_v<C>;
- \
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C = std::uint8_t, class... CC>
     std::vector<C, CC...> h2b(const void* h, std::size_t hsize, HexEndian he = HexEndian::little) requires std::is_standard_layout_v<C>;
@@ -39,6 +62,44 @@ namespace dci::utils
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C = std::uint8_t, std::size_t N>
     bool h2b(const char* csz, std::array<C, N>& buf, HexEndian he = HexEndian::little) requires std::is_standard_layout_v<C>;
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // фиксированного размера, до details::hexFixedLimit байт без вызова библиотеки
+    template <std::size_t HN, class C, std::size_t N>
+    bool h2b(const std::array<char, HN>& h, std::array<C, N>& b, HexEndian he = HexEndian::little) requires (std::is_standard_layout_v<C> && HN == N*sizeof(C)*2);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // то же что h2b, но пригодно для константных выражений
+    constexpr bool h2bConstexpr(const char* h, std::size_t hsize, std::uint8_t* b, HexEndian he = HexEndian::little);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // только при компиляции, недопустимый символ - ошибка компиляции
+    template <std::size_t N>
+    consteval std::array<std::uint8_t, N/2> h2bStatic(const char (&csz)[N], HexEndian he = HexEndian::little);
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для тестов: число наборов ядер, пригодных на этом процессоре (0 - рабочий, последний -
+    // скалярный эталон), и h2b заданным набором
+    std::size_t API_DCI_UTILS h2bVariants();
+    bool API_DCI_UTILS h2bVariant(std::size_t variant, const void* h, std::size_t hsize, void* b, std::size_t& badOffset, HexEndian he);
+
+    template <std::size_t N>
+    struct HexLiteral
+    {
+        consteval HexLiteral(const char (&csz)[N]);
+        char _csz[N];
+    };
+}
+
+namespace dci::utils::literals
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // "deadbeef"_hex -> std::array<std::uint8_t, 4>{0xde, 0xad, 0xbe, 0xef}, порядок байт как в записи (HexEndian::middle)
+    template <details::HexLiteral literal>
+    consteval auto operator""_hex();
 }
 
 #include "h2b.ipp"
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "h2b.hpp"
+#include "hexFixed.hpp"
 #include <dci/utils/dbg.hpp>
 
 namespace dci::utils
@@ -20,6 +21,17 @@ namespace dci::utils
         return h2b(h, hsize, b.data(), he);
     }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class C, class... CC>
+    bool h2bSeparated(std::string_view h, std::vector<C, CC...>& b, HexEndian he, std::string_view separators, bool allowPrefix) requires (sizeof(C) == 1)
+    {
+        b.resize((h.size()+1)/2);
+        std::size_t bsize{0};
+        bool res = h2bSeparated(h.data(), h.size(), b.data(), bsize, he, separators, allowPrefix);
+        b.resize(res ? bsize : 0);
+        return res;
+    }
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     template <class C, class... CC>
     bool h2b(const char* csz, std::vector<C, CC...>& b, HexEndian he) requires std::is_standard_layout_v<C>
@@ -60,6 +72,14 @@ namespace dci::utils
             return false;
         }
 
+        if constexpr(N*sizeof(C) <= details::hexFixedLimit)
+        {
+            if(hsize == bufSize*2)
+            {
+                return details::h2bFixed<N*sizeof(C)>(csz, static_cast<std::uint8_t *>(static_cast<void *>(buf.data())), he);
+            }
+        }
+
         if(!h2b(csz, hsize, buf.data(), he))
         {
             return false;
@@ -74,4 +94,131 @@ namespace dci::utils
         return true;
     }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t HN, class C, std::size_t N>
+    bool h2b(const std::array<char, HN>& h, std::array<C, N>& b, HexEndian he) requires (std::is_standard_layout_v<C> && HN == N*sizeof(C)*2)
+    {
+        std::uint8_t* b8 = static_cast<std::uint8_t *>(static_cast<void *>(b.data()));
+
+        if constexpr(N*sizeof(C) <= details::hexFixedLimit)
+            return details::h2bFixed<N*sizeof(C)>(h.data(), b8, he);
+        else
+            return h2b(h.data(), HN, b8, he);
+    }
+
+    namespace details
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        constexpr bool h2bConstexprDgt(char h, std::uint8_t& b)
+        {
+            if(h >= '0' && h <= '9')
+            {
+                b = static_cast<std::uint8_t>(h-'0');
+                return true;
+            }
+
+            if(h >= 'a' && h <= 'f')
+            {
+                b = static_cast<std::uint8_t>(h-'a'+10);
+                return true;
+            }
+
+            if(h >= 'A' && h <= 'F')
+            {
+                b = static_cast<std::uint8_t>(h-'A'+10);
+                return true;
+            }
+
+            return false;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // намеренно не constexpr: вызов при вычислении константы дает ошибку компиляции с этим именем в диагностике
+        inline void hexLiteralHasBadDigit() {}
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr bool h2bConstexpr(const char* h, std::size_t hsize, std::uint8_t* b, HexEndian he)
+    {
+        std::uint8_t first{}, second{};
+
+        switch(he)
+        {
+        case HexEndian::little:
+        case HexEndian::middle:
+            for(std::size_t i{0}; i<hsize/2; ++i)
+            {
+                if(!details::h2bConstexprDgt(h[i*2+0], first)) return false;
+                if(!details::h2bConstexprDgt(h[i*2+1], second)) return false;
+
+                b[i] = HexEndian::little == he ?
+                           static_cast<std::uint8_t>((second<<4) | first) :
+                           static_cast<std::uint8_t>((first<<4) | second);
+            }
+
+            if(hsize & 1)
+            {
+                if(!details::h2bConstexprDgt(h[hsize-1], first)) return false;
+                b[hsize/2] = HexEndian::little == he ? first : static_cast<std::uint8_t>(first<<4);
+            }
+
+            return true;
+
+        case HexEndian::big:
+            if(hsize & 1)
+            {
+                if(!details::h2bConstexprDgt(h[hsize-1], second)) return false;
+
+                *b = second;
+                ++b;
+                hsize -= 1;
+            }
+
+            for(std::size_t i{0}; i<hsize/2; ++i)
+            {
+                if(!details::h2bConstexprDgt(h[hsize-2-i*2], first)) return false;
+                if(!details::h2bConstexprDgt(h[hsize-1-i*2], second)) return false;
+
+                b[i] = static_cast<std::uint8_t>((first<<4) | second);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t N>
+    consteval std::array<std::uint8_t, N/2> h2bStatic(const char (&csz)[N], HexEndian he)
+    {
+        static_assert(N > 0);
+
+        std::array<std::uint8_t, N/2> res{};
+        if(!h2bConstexpr(csz, N-1, res.data(), he))
+            details::hexLiteralHasBadDigit();
+
+        return res;
+    }
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t N>
+    consteval HexLiteral<N>::HexLiteral(const char (&csz)[N])
+    {
+        for(std::size_t i{0}; i<N; ++i)
+            _csz[i] = csz[i];
+    }
+}
+
+namespace dci::utils::literals
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <details::HexLiteral literal>
+    consteval auto operator""_hex()
+    {
+        return h2bStatic(literal._csz, HexEndian::middle);
+    }
 }
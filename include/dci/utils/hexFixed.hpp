@@ -0,0 +1,154 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+#include <bit>
+#include "hexEndian.hpp"
+
+// кодирование фиксированного размера прямо в заголовке, без вызова библиотеки:
+// по 4 байта / 8 символов в 64-битном слове (SWAR), цикл разворачивается компилятором полностью
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // до этого размера в байтах std::array-перегрузки b2h/h2b обходятся без вызова библиотеки
+    constexpr std::size_t hexFixedLimit = 64;
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr std::uint64_t hexFixedBytes(std::uint8_t v)
+    {
+        return v * 0x0101010101010101ull;
+    }
+
+    constexpr std::uint32_t hexFixedSwap(std::uint32_t v)
+    {
+        return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // 4 байта -> 8 символов, байты в порядке памяти
+    inline std::uint64_t b2hFixed4(std::uint32_t x, bool lowFirst)
+    {
+        std::uint64_t v = x;
+        v = (v | v << 16) & 0x0000ffff0000ffffull;
+        v = (v | v <<  8) & 0x00ff00ff00ff00ffull;
+
+        std::uint64_t hi = (v >> 4) & 0x000f000f000f000full;
+        std::uint64_t lo = v & 0x000f000f000f000full;
+        std::uint64_t n = lowFirst ? (lo | hi << 8) : (hi | lo << 8);
+
+        // 0..9 -> '0'..'9', 10..15 -> 'a'..'f'
+        std::uint64_t letter = ((n + hexFixedBytes(0x06)) >> 4) & hexFixedBytes(0x01);
+        return n + hexFixedBytes('0') + letter * ('a' - '0' - 10);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // 8 символов -> 4 байта, false если есть недопустимый символ
+    inline bool h2bFixed4(std::uint64_t c, bool lowFirst, std::uint32_t& x)
+    {
+        const std::uint64_t high = hexFixedBytes(0x80);
+
+        // старший бит сразу означает ошибку, без него сложения ниже не переносятся между байтами
+        std::uint64_t nonAscii = c & high;
+        std::uint64_t digit = (c + hexFixedBytes(0x80-'0')) & ~(c + hexFixedBytes(0x80-'9'-1)) & high;
+        std::uint64_t l = c | hexFixedBytes(0x20);
+        std::uint64_t letter = (l + hexFixedBytes(0x80-'a')) & ~(l + hexFixedBytes(0x80-'f'-1)) & high;
+
+        if(nonAscii | ((digit | letter) ^ high))
+            return false;
+
+        std::uint64_t n = (c & hexFixedBytes(0x0f)) + (letter >> 7) * 9;
+
+        std::uint64_t first  = n & 0x00ff00ff00ff00ffull;
+        std::uint64_t second = (n >> 8) & 0x00ff00ff00ff00ffull;
+        std::uint64_t v = lowFirst ? (first | second << 4) : (first << 4 | second);
+
+        v = (v | v >>  8) & 0x0000ffff0000ffffull;
+        v = (v | v >> 16) & 0x00000000ffffffffull;
+        x = static_cast<std::uint32_t>(v);
+        return true;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline void b2hFixed1(std::uint8_t b, char* h, bool lowFirst)
+    {
+        constexpr const char* digits = "0123456789abcdef";
+        h[0] = digits[lowFirst ? b & 0x0f : b >> 4];
+        h[1] = digits[lowFirst ? b >> 4 : b & 0x0f];
+    }
+
+    inline bool h2bFixed1(const char* h, std::uint8_t& b, bool lowFirst)
+    {
+        std::uint64_t c = (hexFixedBytes('0') & ~0xffffull) |
+                          static_cast<std::uint8_t>(h[0]) |
+                          static_cast<std::uint64_t>(static_cast<std::uint8_t>(h[1])) << 8;
+
+        std::uint32_t x;
+        if(!h2bFixed4(c, lowFirst, x))
+            return false;
+
+        b = static_cast<std::uint8_t>(x);
+        return true;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t N>
+    void b2hFixed(const std::uint8_t* b, char* h, HexEndian he)
+    {
+        bool lowFirst = HexEndian::little == he;
+        bool reverse = HexEndian::big == he;
+
+        constexpr std::size_t head = std::endian::native == std::endian::little ? N/4*4 : 0;
+
+        for(std::size_t i{0}; i<head; i += 4)
+        {
+            std::uint32_t x;
+            std::memcpy(&x, reverse ? b+N-4-i : b+i, 4);
+            if(reverse)
+                x = hexFixedSwap(x);
+
+            std::uint64_t v = b2hFixed4(x, lowFirst);
+            std::memcpy(h + i*2, &v, 8);
+        }
+
+        for(std::size_t i{head}; i<N; ++i)
+            b2hFixed1(reverse ? b[N-1-i] : b[i], h + i*2, lowFirst);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t N>
+    bool h2bFixed(const char* h, std::uint8_t* b, HexEndian he)
+    {
+        bool lowFirst = HexEndian::little == he;
+        bool reverse = HexEndian::big == he;
+
+        // SWAR-часть по 4 байта только на little-endian, остальное побайтно
+        constexpr std::size_t head = std::endian::native == std::endian::little ? N/4*4 : 0;
+
+        for(std::size_t i{0}; i<head; i += 4)
+        {
+            std::uint64_t c;
+            std::memcpy(&c, reverse ? h+(N-4-i)*2 : h+i*2, 8);
+
+            std::uint32_t x;
+            if(!h2bFixed4(c, lowFirst, x))
+                return false;
+
+            if(reverse)
+                x = hexFixedSwap(x);
+            std::memcpy(b+i, &x, 4);
+        }
+
+        for(std::size_t i{head}; i<N; ++i)
+            if(!h2bFixed1(reverse ? h+(N-1-i)*2 : h+i*2, b[i], lowFirst))
+                return false;
+
+        return true;
+    }
+}
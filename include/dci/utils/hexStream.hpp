@@ -0,0 +1,74 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "api.hpp"
+#include <cstdint>
+#include <cstddef>
+#include "hexEndian.hpp"
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Потоковые кодеки для входа, поступающего порциями произвольного размера. Выход всегда пишется в буфер вызывающего.
+    // HexEndian::big не поддерживается - для него нужен весь вход целиком, конструкторы бросают std::invalid_argument.
+    class API_DCI_UTILS HexEncoder
+    {
+    public:
+        HexEncoder(HexEndian he = HexEndian::little);
+
+    public:
+        // сколько символов даст очередная порция из bsize байт
+        static std::size_t outputSize(std::size_t bsize);
+
+        // пишет outputSize(bsize) символов в h, возвращает их количество
+        std::size_t update(const void* b, std::size_t bsize, void* h);
+
+        std::uint64_t consumed() const;
+        void reset();
+
+    private:
+        HexEndian       _he;
+        std::uint64_t   _consumed{};
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    class API_DCI_UTILS HexDecoder
+    {
+    public:
+        HexDecoder(HexEndian he = HexEndian::little);
+
+    public:
+        // сколько байт даст очередная порция из hsize символов, с учетом перенесенного полубайта
+        std::size_t outputSize(std::size_t hsize) const;
+
+        // пишет целые байты в b, bsize - их количество. Нечетный последний символ переносится в следующий вызов.
+        // false - встречен недопустимый символ, декодер переходит в состояние ошибки до reset
+        bool update(const void* h, std::size_t hsize, void* b, std::size_t& bsize);
+
+        // завершение потока: перенесенный полубайт выдается как неполный байт, так же как h2b для нечетного hsize
+        bool finish(void* b, std::size_t& bsize);
+
+        bool pending() const;
+        bool failed() const;
+
+        // позиция первого недопустимого символа от начала потока
+        std::uint64_t badOffset() const;
+
+        std::uint64_t consumed() const;
+        void reset();
+
+    private:
+        HexEndian       _he;
+        std::uint64_t   _consumed{};
+        std::uint64_t   _badOffset{};
+        bool            _failed{};
+        bool            _pending{};
+        char            _pendingChar{};
+    };
+}
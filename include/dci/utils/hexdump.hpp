@@ -0,0 +1,44 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "api.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <iosfwd>
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // по умолчанию - формат `hexdump -C`, без схлопывания повторяющихся строк:
+    // 00000000  de ad be ef 00 11 22 33  44 55 66 77 88 99 aa bb  |......"3DUfw....|
+    struct HexdumpFormat
+    {
+        std::size_t     _width          {16};   // байт в строке, 0 - как по умолчанию
+        std::size_t     _group          {8};    // байт в группе, группы разделяются дополнительным пробелом
+        bool            _ascii          {true}; // колонка печатных символов
+        std::size_t     _offsetDigits   {8};    // минимальная ширина колонки смещения
+        std::uint64_t   _baseOffset     {0};    // смещение первого байта
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // точный размер результата
+    std::size_t API_DCI_UTILS hexdumpSize(std::size_t bsize, const HexdumpFormat& format = {});
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // пишет hexdumpSize(bsize, format) символов в out
+    void API_DCI_UTILS hexdump(const void* b, std::size_t bsize, char* out, const HexdumpFormat& format = {});
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string API_DCI_UTILS hexdump(const void* b, std::size_t bsize, const HexdumpFormat& format = {});
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // пишет порциями по несколько строк, без промежуточного буфера на весь результат
+    void API_DCI_UTILS hexdump(const void* b, std::size_t bsize, std::ostream& out, const HexdumpFormat& format = {});
+}
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "api.hpp"
+#include "fnv1a.hpp"
 #include <cstdint>
 #include <array>
 #include <string_view>
@@ -54,6 +55,17 @@ namespace dci::utils::ip
     using Port = std::uint16_t;
     using LinkId = std::uint32_t;
 
+    // Address4/Address6 - псевдонимы std::array, std::hash для них специализировать нельзя;
+    // hash - fnv1a по байтам адреса, Hash - для std::unordered_* и т.п.
+    constexpr std::uint64_t hash(const Address4& addr);
+    constexpr std::uint64_t hash(const Address6& addr);
+
+    struct Hash
+    {
+        constexpr std::size_t operator()(const Address4& addr) const;
+        constexpr std::size_t operator()(const Address6& addr) const;
+    };
+
     Scope API_DCI_UTILS scope(const Address4& addr);
     Scope API_DCI_UTILS scope(const Address6& addr);
     Scope API_DCI_UTILS scope(std::string_view addr, Scope dflt = {});
@@ -119,3 +131,30 @@ namespace dci::utils::ip
         return static_cast<UT>(a) | static_cast<UT>(b);
     }
 }
+
+namespace dci::utils::ip
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr std::uint64_t hash(const Address4& addr)
+    {
+        return fnv1a(addr.data(), addr.size());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr std::uint64_t hash(const Address6& addr)
+    {
+        return fnv1a(addr.data(), addr.size());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr std::size_t Hash::operator()(const Address4& addr) const
+    {
+        return static_cast<std::size_t>(hash(addr));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    constexpr std::size_t Hash::operator()(const Address6& addr) const
+    {
+        return static_cast<std::size_t>(hash(addr));
+    }
+}
@@ -0,0 +1,70 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "fnv1a.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <bit>
+#include <utility>
+#include <string_view>
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Совершенный хеш для фиксированного набора строк, строится при компиляции.
+    // Поиск - один fnv1a от ключа, одна ячейка таблицы и одно сравнение строк,
+    // замена для вложенных switch по первому символу/длине с последующим ==.
+    //
+    //  constexpr auto schemes = perfectHash<Scheme>({{"http", Scheme::http}, {"ftp", Scheme::ftp}});
+    //  if(const Scheme* s = schemes.find(str)) ...
+    template <class Value, std::size_t N>
+    class PerfectHash
+    {
+        static_assert(N > 0);
+
+    public:
+        using Item = std::pair<std::string_view, Value>;
+
+        // ключи должны быть различны, иначе ошибка компиляции
+        consteval PerfectHash(const Item (&items)[N]);
+
+        static constexpr std::size_t size();
+
+        // позиция ключа в items, N если ключ не из набора
+        constexpr std::size_t index(std::string_view key) const;
+
+        constexpr const Value* find(std::string_view key) const;
+        constexpr Value value(std::string_view key, const Value& missing) const;
+
+        constexpr const Item& item(std::size_t index) const;
+
+    private:
+        static constexpr std::size_t _slotsAmount = std::bit_ceil(N*2);
+        static constexpr int _slotsBits = std::countr_zero(_slotsAmount);
+
+        static constexpr std::size_t slot(std::uint64_t hash, std::uint64_t seed);
+
+        // seed перебирается до отсутствия коллизий
+        std::array<Item, N> _items{};
+        std::array<std::size_t, _slotsAmount> _slots{};
+        std::uint64_t _seed{};
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    consteval PerfectHash<Value, N> perfectHash(const std::pair<std::string_view, Value> (&items)[N]);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // значения - позиции ключей
+    template <std::size_t N>
+    consteval PerfectHash<std::size_t, N> perfectHash(const std::string_view (&keys)[N]);
+}
+
+#include "perfectHash.ipp"
@@ -0,0 +1,115 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include "perfectHash.hpp"
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    consteval PerfectHash<Value, N>::PerfectHash(const Item (&items)[N])
+    {
+        std::array<std::uint64_t, N> hashes{};
+        for(std::size_t i{0}; i<N; ++i)
+        {
+            _items[i] = items[i];
+            hashes[i] = fnv1a(items[i].first);
+
+            for(std::size_t j{0}; j<i; ++j)
+                if(_items[j].first == _items[i].first)
+                    throw "PerfectHash: duplicate key";
+        }
+
+        // таблица заполнена не более чем наполовину, подходящий seed находится за единицы-десятки попыток
+        for(std::uint64_t seed{0}; seed<0x10000; ++seed)
+        {
+            _slots.fill(N);
+
+            bool collision{false};
+            for(std::size_t i{0}; i<N && !collision; ++i)
+            {
+                std::size_t& s = _slots[slot(hashes[i], seed)];
+                collision = s != N;
+                s = i;
+            }
+
+            if(!collision)
+            {
+                _seed = seed;
+                return;
+            }
+        }
+
+        throw "PerfectHash: no seed found";
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr std::size_t PerfectHash<Value, N>::size()
+    {
+        return N;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr std::size_t PerfectHash<Value, N>::index(std::string_view key) const
+    {
+        std::size_t i = _slots[slot(fnv1a(key), _seed)];
+        return i < N && _items[i].first == key ? i : N;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr const Value* PerfectHash<Value, N>::find(std::string_view key) const
+    {
+        std::size_t i = index(key);
+        return i < N ? &_items[i].second : nullptr;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr Value PerfectHash<Value, N>::value(std::string_view key, const Value& missing) const
+    {
+        std::size_t i = index(key);
+        return i < N ? _items[i].second : missing;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr const typename PerfectHash<Value, N>::Item& PerfectHash<Value, N>::item(std::size_t index) const
+    {
+        return _items[index];
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    constexpr std::size_t PerfectHash<Value, N>::slot(std::uint64_t hash, std::uint64_t seed)
+    {
+        // младшие биты fnv1a у коротких ключей слабо перемешаны, поэтому берутся старшие биты произведения
+        return static_cast<std::size_t>(((hash ^ seed) * 0x9e3779b97f4a7c15ull) >> (64 - _slotsBits));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class Value, std::size_t N>
+    consteval PerfectHash<Value, N> perfectHash(const std::pair<std::string_view, Value> (&items)[N])
+    {
+        return PerfectHash<Value, N>{items};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <std::size_t N>
+    consteval PerfectHash<std::size_t, N> perfectHash(const std::string_view (&keys)[N])
+    {
+        std::pair<std::string_view, std::size_t> items[N];
+        for(std::size_t i{0}; i<N; ++i)
+            items[i] = {keys[i], i};
+
+        return PerfectHash<std::size_t, N>{items};
+    }
+}
@@ -8,10 +8,16 @@
 #pragma once
 
 #include "api.hpp"
+#include "fnv1a.hpp"
 #include <string>
 #include <string_view>
+#include <memory_resource>
 #include <variant>
 #include <optional>
+#include <functional>
+#include <vector>
+#include <span>
+#include <cstdint>
 
 namespace dci::utils::uri
 {
@@ -234,24 +240,141 @@ namespace dci::utils
 
 namespace dci::utils::uri
 {
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // вид URI, совпадает с индексом альтернативы в URI<String>
+    enum class Kind : std::uint8_t
+    {
+        unknown,
+        generic,
+        mailto,
+        inproc,
+        local,
+        file,
+        tcp,
+        tcp4,
+        tcp6,
+        udp,
+        udp4,
+        udp6,
+        www,
+        http,
+        https,
+        ftp,
+        ftps,
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // вид хоста, совпадает с индексом альтернативы в networkNode::Host<String>
+    enum class HostKind : std::uint8_t
+    {
+        ip4,
+        ip6,
+        ipFuture,
+        regName,
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // участок исходной строки; absent - компоненты нет (в отличие от пустой)
+    struct Slice
+    {
+        static constexpr std::uint32_t absent = ~std::uint32_t{};
+
+        std::uint32_t _offset{absent};
+        std::uint32_t _size{};
+
+        bool present() const;
+        std::string_view of(std::string_view src) const;
+        auto operator<=>(const Slice&) const = default;
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Результат пакетного разбора по столбцам, i-й элемент каждого столбца относится к i-й строке входа.
+    // host - то же, что дает host(), для inproc и local - authority. host, port и path заполнены только
+    // при _status == ok, scheme, query и fragment - как у parse() и при неудаче
+    struct Batch
+    {
+        enum class Status : std::uint8_t
+        {
+            ok,         // parse() вернул бы true
+            malformed,  // parse() вернул бы false
+            tooLong,    // строка не адресуется 32-битными смещениями
+        };
+
+        std::vector<Kind>   _kind;
+        std::vector<Status> _status;
+        std::vector<Slice>  _scheme;
+        std::vector<Slice>  _host;
+        std::vector<Slice>  _port;
+        std::vector<Slice>  _path;
+        std::vector<Slice>  _query;
+        std::vector<Slice>  _fragment;
+
+        std::size_t size() const;
+        void resize(std::size_t size);
+    };
+
     bool API_DCI_UTILS parse(std::string_view src, URI<std::string_view>& dst);
     bool API_DCI_UTILS parse(std::string_view src, URI<std::string>&      dst);
 
+    // все строки dst - из mr, например из std::pmr::monotonic_buffer_resource на время запроса
+    bool API_DCI_UTILS parse(std::string_view src, URI<std::pmr::string>& dst, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // пакетный разбор без построения URI<String>; строки srcs должны жить, пока используются участки из dst
+    void API_DCI_UTILS parseBatch(std::span<const std::string_view> srcs, Batch& dst);
+
+    // то же на общем пуле потоков; до serialThreshold строк - обычный однопоточный parseBatch
+    constexpr std::size_t parseBatchParallelThreshold = 4096;
+    void API_DCI_UTILS parseBatchParallel(std::span<const std::string_view> srcs, Batch& dst, std::size_t serialThreshold = parseBatchParallelThreshold);
+
     bool API_DCI_UTILS valid(std::string_view src);
     template <class... Alts> bool valid(std::string_view src);
 
     std::string_view API_DCI_UTILS scheme(std::string_view src);
     std::string_view API_DCI_UTILS scheme(const URI<std::string_view>& src);
     std::string_view API_DCI_UTILS scheme(const URI<std::string>& src);
+    std::string_view API_DCI_UTILS scheme(const URI<std::pmr::string>& src);
     std::string_view API_DCI_UTILS host(std::string_view src);
     std::string_view API_DCI_UTILS host(const URI<std::string_view>& src);
     std::string_view API_DCI_UTILS host(const URI<std::string>& src);
+    std::string_view API_DCI_UTILS host(const URI<std::pmr::string>& src);
     std::string API_DCI_UTILS hostPort(std::string_view src);
     std::string API_DCI_UTILS hostPort(const URI<std::string_view>& src);
     std::string API_DCI_UTILS hostPort(const URI<std::string>& src);
+    std::string API_DCI_UTILS hostPort(const URI<std::pmr::string>& src);
+
+    // hostPort без промежуточных строк. В buf - только если результат помещается в bufSize (без
+    // завершающего нуля), иначе buf не меняется; возвращается длина результата в любом случае
+    std::size_t API_DCI_UTILS hostPort(std::string_view src, char* buf, std::size_t bufSize);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string_view>& src, char* buf, std::size_t bufSize);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string>& src, char* buf, std::size_t bufSize);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::pmr::string>& src, char* buf, std::size_t bufSize);
+
+    // дописывает hostPort к dst, не более одного выделения памяти; возвращает длину дописанного
+    std::size_t API_DCI_UTILS hostPort(std::string_view src, std::string& dst);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string_view>& src, std::string& dst);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string>& src, std::string& dst);
+    std::size_t API_DCI_UTILS hostPort(const URI<std::pmr::string>& src, std::string& dst);
+
     bool API_DCI_UTILS isCover(std::string_view base, std::string_view target);
     bool API_DCI_UTILS isCover(const URI<std::string_view>& base, const URI<std::string_view>& target);
     bool API_DCI_UTILS isCover(const URI<std::string>& base, const URI<std::string>& target);
+    bool API_DCI_UTILS isCover(const URI<std::pmr::string>& base, const URI<std::pmr::string>& target);
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Кэш разбора для scheme/host/hostPort/isCover от строк: результаты для capacity
+    // последних разных строк, вытеснение CLOCK; потокобезопасен. По умолчанию выключен (0).
+    // setCacheCapacity сбрасывает и содержимое, и счетчики
+    struct CacheStats
+    {
+        std::uint64_t _hits{};
+        std::uint64_t _misses{};
+        std::size_t   _size{};
+        std::size_t   _capacity{};
+    };
+
+    void API_DCI_UTILS setCacheCapacity(std::size_t capacity);
+    CacheStats API_DCI_UTILS cacheStats();
 }
 
 namespace dci::utils::uri
@@ -273,6 +396,62 @@ namespace dci::utils
     template <class Out, class String> Out& operator<<(Out& out, const URI<String>& in);
 }
 
+namespace dci::utils::uri
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // fnv1a прямо по хранимым компонентам, без сериализации; согласовано с operator== (равные дают равный хеш),
+    // не зависит от String - URI<std::string> и URI<std::string_view> с одинаковым содержимым хешируются одинаково
+    template <class T> std::uint64_t hash(const T& in) requires requires (Fnv1a& h) {hashAppend(h, in);};
+
+    // для std::unordered_*, FlatMap и т.п.
+    struct Hash
+    {
+        template <class T> std::size_t operator()(const T& in) const requires requires {uri::hash(in);};
+    };
+
+    template <class String> void hashAppend(Fnv1a& h, const Unknown<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const Generic<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const Mailto<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const Inproc<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const Local<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const File<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const networkNode::Host<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const NetworkNode<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const TCP<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const UDP<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const www::Userinfo<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const www::Authority<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const WWW<String>& in);
+    template <class String> void hashAppend(Fnv1a& h, const URI<String>& in);
+}
+
+namespace std
+{
+    template <class String> struct hash<dci::utils::uri::Unknown<String>>       : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::Generic<String>>       : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::Mailto<String>>        : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::Inproc<String>>        : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::Local<String>>         : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::File<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::NetworkNode<String>>   : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::TCP<String>>           : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::TCP4<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::TCP6<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::UDP<String>>           : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::UDP4<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::UDP6<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::www::Userinfo<String>> : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::www::Authority<String>>: dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::WWW<String>>           : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::HTTP<String>>          : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::HTTPS<String>>         : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::FTP<String>>           : dci::utils::uri::Hash {};
+    template <class String> struct hash<dci::utils::uri::FTPS<String>>          : dci::utils::uri::Hash {};
+
+    // более специальная, чем стандартная для std::variant: тот же хеш что у uri::hash
+    template <class String> struct hash<dci::utils::URI<String>>                : dci::utils::uri::Hash {};
+}
+
 namespace dci::utils::uri
 {
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -394,6 +573,155 @@ namespace dci::utils
     }
 }
 
+namespace dci::utils::uri::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // длина вместе с содержимым, чтобы ("ab","c") и ("a","bc") различались
+    template <class String> void hashAppendString(Fnv1a& h, const String& in)
+    {
+        std::string_view sv{in};
+        std::uint64_t size = sv.size();
+        h.update(reinterpret_cast<const unsigned char*>(&size), sizeof(size));
+        h.update(sv.data(), sv.size());
+    }
+
+    template <class String> void hashAppendString(Fnv1a& h, const std::optional<String>& in)
+    {
+        unsigned char has = in ? 1 : 0;
+        h.update(&has, 1);
+        if(in)
+            hashAppendString(h, *in);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline void hashAppendIndex(Fnv1a& h, std::size_t index)
+    {
+        unsigned char byte = static_cast<unsigned char>(index);
+        h.update(&byte, 1);
+    }
+}
+
+namespace dci::utils::uri
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class T> std::uint64_t hash(const T& in) requires requires (Fnv1a& h) {hashAppend(h, in);}
+    {
+        Fnv1a h;
+        hashAppend(h, in);
+        return h.digest();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class T> std::size_t Hash::operator()(const T& in) const requires requires {uri::hash(in);}
+    {
+        return static_cast<std::size_t>(uri::hash(in));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const Unknown<String>& in)
+    {
+        details::hashAppendString(h, in._content);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const Generic<String>& in)
+    {
+        details::hashAppendString(h, in._scheme);
+        details::hashAppendString(h, in._hierPart);
+        details::hashAppendString(h, in._query);
+        details::hashAppendString(h, in._fragment);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const Mailto<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        details::hashAppendString(h, in._value);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const Inproc<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        details::hashAppendString(h, in._auth);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const Local<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        details::hashAppendString(h, in._auth);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const File<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        details::hashAppendString(h, in._auth);
+        details::hashAppendString(h, in._path);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const networkNode::Host<String>& in)
+    {
+        details::hashAppendIndex(h, in.index());
+        std::visit([&](const auto& alt) { details::hashAppendString(h, static_cast<const String&>(alt)); }, in);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const NetworkNode<String>& in)
+    {
+        hashAppend(h, in._host);
+        details::hashAppendString(h, in._port);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const TCP<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        hashAppend(h, in._auth);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const UDP<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        hashAppend(h, in._auth);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const www::Userinfo<String>& in)
+    {
+        details::hashAppendString(h, in._name);
+        details::hashAppendString(h, in._password);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const www::Authority<String>& in)
+    {
+        unsigned char has = in._userinfo ? 1 : 0;
+        h.update(&has, 1);
+        if(in._userinfo)
+            hashAppend(h, *in._userinfo);
+        hashAppend(h, in._networkNode);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const WWW<String>& in)
+    {
+        hashAppend(h, static_cast<const Generic<String>&>(in));
+        hashAppend(h, in._auth);
+        details::hashAppendString(h, in._path);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    template <class String> void hashAppend(Fnv1a& h, const URI<String>& in)
+    {
+        details::hashAppendIndex(h, in.index());
+        std::visit([&](const auto& alt) { hashAppend(h, alt); }, in);
+    }
+}
+
 namespace dci::utils::uri
 {
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -403,3 +731,37 @@ namespace dci::utils::uri
         return parse(src, tmp) && (std::holds_alternative<Alts>(tmp) || ...);
     }
 }
+
+namespace dci::utils::uri
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline bool Slice::present() const
+    {
+        return absent != _offset;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline std::string_view Slice::of(std::string_view src) const
+    {
+        return present() ? src.substr(_offset, _size) : std::string_view{};
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline std::size_t Batch::size() const
+    {
+        return _kind.size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline void Batch::resize(std::size_t size)
+    {
+        _kind.resize(size);
+        _status.resize(size);
+        _scheme.resize(size);
+        _host.resize(size);
+        _port.resize(size);
+        _path.resize(size);
+        _query.resize(size);
+        _fragment.resize(size);
+    }
+}
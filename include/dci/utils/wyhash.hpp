@@ -0,0 +1,26 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace dci::utils
+{
+    // wyhash (final4, W. Yi): по 16-48 байт за шаг через 64x64->128 умножение, пригоден для хеш-таблиц.
+    // Материал - байты, seed - только в форме указатель+длина. Результат одинаков при вычислении в константном выражении и во время выполнения
+    template <class Char>
+    constexpr std::uint64_t wyhash(const Char* material, std::size_t len, std::uint64_t seed = 0) requires (sizeof(Char) == 1);
+
+    template <class Container>
+    constexpr std::uint64_t wyhash(const Container& material) requires requires {material.data(); material.size();};
+
+    template <class LiteralChar, std::size_t N>
+    constexpr std::uint64_t wyhash(const LiteralChar (&material)[N]);
+}
+
+#include "wyhash.ipp"
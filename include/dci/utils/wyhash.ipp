@@ -0,0 +1,147 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
+
+namespace dci::utils::details
+{
+    constexpr std::uint64_t wyhashSecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+    constexpr void wyhashMum(std::uint64_t& a, std::uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 r = a;
+        r *= b;
+        a = static_cast<std::uint64_t>(r);
+        b = static_cast<std::uint64_t>(r >> 64);
+#else
+        std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+        std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        std::uint64_t t = rl + (rm0 << 32);
+        std::uint64_t c = t < rl;
+        std::uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        a = lo;
+        b = hi;
+#endif
+    }
+
+    constexpr std::uint64_t wyhashMix(std::uint64_t a, std::uint64_t b)
+    {
+        wyhashMum(a, b);
+        return a ^ b;
+    }
+
+    // чтение little-endian слова; вне константного выражения - обычная невыровненная загрузка
+    template <std::size_t size, class Char>
+    constexpr std::uint64_t wyhashRead(const Char* p)
+    {
+        if(!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+        {
+            std::conditional_t<8 == size, std::uint64_t, std::uint32_t> res;
+            std::memcpy(&res, p, size);
+            return res;
+        }
+
+        std::uint64_t res{0};
+        for(std::size_t i{0}; i<size; ++i)
+            res |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[i])) << (i*8);
+        return res;
+    }
+
+    template <class Char>
+    constexpr std::uint64_t wyhashRead3(const Char* p, std::size_t k)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[0])) << 16) |
+               (static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[k >> 1])) << 8) |
+               static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[k - 1]));
+    }
+}
+
+namespace dci::utils
+{
+    template <class Char>
+    constexpr std::uint64_t wyhash(const Char* material, std::size_t len, std::uint64_t seed) requires (sizeof(Char) == 1)
+    {
+        using namespace details;
+        constexpr const std::uint64_t* secret = wyhashSecret;
+
+        const Char* p = material;
+        seed ^= wyhashMix(seed ^ secret[0], secret[1]);
+
+        std::uint64_t a, b;
+        if(len <= 16)
+        {
+            if(len >= 4)
+            {
+                a = (wyhashRead<4>(p) << 32) | wyhashRead<4>(p + ((len >> 3) << 2));
+                b = (wyhashRead<4>(p + len - 4) << 32) | wyhashRead<4>(p + len - 4 - ((len >> 3) << 2));
+            }
+            else if(len > 0)
+            {
+                a = wyhashRead3(p, len);
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            std::size_t i = len;
+            if(i > 48)
+            {
+                std::uint64_t see1 = seed, see2 = seed;
+                do
+                {
+                    seed = wyhashMix(wyhashRead<8>(p)    ^ secret[1], wyhashRead<8>(p+8)  ^ seed);
+                    see1 = wyhashMix(wyhashRead<8>(p+16) ^ secret[2], wyhashRead<8>(p+24) ^ see1);
+                    see2 = wyhashMix(wyhashRead<8>(p+32) ^ secret[3], wyhashRead<8>(p+40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                }
+                while(i > 48);
+
+                seed ^= see1 ^ see2;
+            }
+
+            while(i > 16)
+            {
+                seed = wyhashMix(wyhashRead<8>(p) ^ secret[1], wyhashRead<8>(p+8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+
+            a = wyhashRead<8>(p + i - 16);
+            b = wyhashRead<8>(p + i - 8);
+        }
+
+        a ^= secret[1];
+        b ^= seed;
+        wyhashMum(a, b);
+        return wyhashMix(a ^ secret[0] ^ len, b ^ secret[1]);
+    }
+
+    template <class Container>
+    constexpr std::uint64_t wyhash(const Container& material) requires requires {material.data(); material.size();}
+    {
+        return wyhash(material.data(), material.size());
+    }
+
+    template <class LiteralChar, std::size_t N>
+    constexpr std::uint64_t wyhash(const LiteralChar (&material)[N])
+    {
+        static_assert(N > 0);
+        return wyhash(&material[0], N-1);
+    }
+}
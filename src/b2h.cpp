@@ -6,71 +6,483 @@
    You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
 
 #include <dci/utils/b2h.hpp>
+#include <dci/utils/endian.hpp>
+#include "cpu.hpp"
+#include "workers.hpp"
+#include <bit>
+#include <algorithm>
+#include <vector>
 
 namespace dci::utils
 {
     namespace
     {
-        char dgt(uint8_t h)
+        constexpr char digits[] = "0123456789abcdef";
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // по одному байту, для хвостов и как эталон
+        template <HexEndian he>
+        void b2h_scalar(const std::uint8_t* b, std::size_t bsize, char* h)
         {
-            if(h < 10)
+            for(std::size_t i(0); i<bsize; ++i)
             {
-                return static_cast<char>('0'+h);
+                if constexpr(HexEndian::little == he)
+                {
+                    h[i*2+0] = digits[b[i]&0xf];
+                    h[i*2+1] = digits[b[i]>>4];
+                }
+                else if constexpr(HexEndian::middle == he)
+                {
+                    h[i*2+0] = digits[b[i]>>4];
+                    h[i*2+1] = digits[b[i]&0xf];
+                }
+                else
+                {
+                    h[i*2+0] = digits[b[bsize-1-i]>>4];
+                    h[i*2+1] = digits[b[bsize-1-i]&0xf];
+                }
             }
-            return static_cast<char>('a'+h-10);
         }
 
-        void b2h_little(const std::uint8_t* b, std::size_t bsize, char* h)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // блочный проход: блоки по blockSize байт обрабатывает kernel, остаток - tail (по умолчанию скалярно).
+        // Для big блоки берутся с конца входа, а недообработанное начало входа ложится в конец выхода.
+        // Встраивается принудительно, иначе kernel с target-атрибутом вызывается на каждый блок
+        template <HexEndian he, std::size_t blockSize, class Kernel, class Tail = decltype(b2h_scalar<he>)&>
+        DCI_UTILS_CPU_INLINE void b2h_blocks(const std::uint8_t* b, std::size_t bsize, char* h, Kernel&& kernel, Tail&& tail = b2h_scalar<he>)
         {
-            for(std::size_t i(0); i<bsize; ++i)
+            std::size_t done{0};
+            for(; done+blockSize <= bsize; done += blockSize)
             {
-                h[i*2+0] = dgt(b[i]&0xf);
-                h[i*2+1] = dgt(b[i]>>4);
+                if constexpr(HexEndian::big == he)
+                    kernel(b + bsize - done - blockSize, h + done*2);
+                else
+                    kernel(b + done, h + done*2);
             }
+
+            if constexpr(HexEndian::big == he)
+                tail(b, bsize-done, h + done*2);
+            else
+                tail(b + done, bsize-done, h + done*2);
         }
 
-        void b2h_middle(const std::uint8_t* b, std::size_t bsize, char* h)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // SWAR, 4 байта за шаг в 64-битном слове
+        template <HexEndian he>
+        void b2h_swar(const std::uint8_t* b, std::size_t bsize, char* h)
         {
-            for(std::size_t i(0); i<bsize; ++i)
+            if constexpr(std::endian::native != std::endian::little)
             {
-                h[i*2+0] = dgt(b[i]>>4);
-                h[i*2+1] = dgt(b[i]&0xf);
+                return b2h_scalar<he>(b, bsize, h);
+            }
+            else
+            {
+                b2h_blocks<he, 4>(b, bsize, h, [](const std::uint8_t* b, char* h)
+                {
+                    std::uint32_t v32;
+                    std::memcpy(&v32, b, 4);
+                    if constexpr(HexEndian::big == he)
+                        v32 = endian::l2b(v32);
+
+                    std::uint64_t v = v32;
+                    v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+                    v = (v | (v <<  8)) & 0x00ff00ff00ff00ffull;
+
+                    std::uint64_t lo = v & 0x000f000f000f000full;
+                    std::uint64_t hi = (v >> 4) & 0x000f000f000f000full;
+                    std::uint64_t n = HexEndian::little == he ? (lo | (hi << 8)) : (hi | (lo << 8));
+
+                    // n<10 -> '0'+n, иначе 'a'+n-10
+                    std::uint64_t alpha = ((n + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+                    n += 0x3030303030303030ull + alpha * ('a' - '0' - 10);
+
+                    std::memcpy(h, &n, 8);
+                });
             }
         }
 
-        void b2h_big(const std::uint8_t* b, std::size_t bsize, char* h)
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("sse2")
+        void b2h_sse2(const std::uint8_t* b, std::size_t bsize, char* h)
         {
-            for(std::size_t i(0); i<bsize; ++i)
+            b2h_blocks<he, 16>(b, bsize, h, [](const std::uint8_t* b, char* h) DCI_UTILS_CPU_TARGET("sse2")
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+                if constexpr(HexEndian::big == he)
+                {
+                    v = _mm_shuffle_epi32(v, 0x1b);
+                    v = _mm_shufflelo_epi16(v, 0xb1);
+                    v = _mm_shufflehi_epi16(v, 0xb1);
+                    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                }
+
+                const __m128i mask = _mm_set1_epi8(0x0f);
+                __m128i lo = _mm_and_si128(v, mask);
+                __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+
+                auto ascii = [&](__m128i n) DCI_UTILS_CPU_TARGET("sse2")
+                {
+                    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+                    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+                };
+                lo = ascii(lo);
+                hi = ascii(hi);
+
+                __m128i first  = HexEndian::little == he ? lo : hi;
+                __m128i second = HexEndian::little == he ? hi : lo;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(h+ 0), _mm_unpacklo_epi8(first, second));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(h+16), _mm_unpackhi_epi8(first, second));
+            });
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // 16 байт -> 32 символа
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE void b2h_block16(const std::uint8_t* b, char* h)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+            if constexpr(HexEndian::big == he)
+                v = _mm_shuffle_epi8(v, _mm_setr_epi8(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0));
+
+            const __m128i mask = _mm_set1_epi8(0x0f);
+            const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+            __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+            __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+
+            __m128i first  = HexEndian::little == he ? lo : hi;
+            __m128i second = HexEndian::little == he ? hi : lo;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h+ 0), _mm_unpacklo_epi8(first, second));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h+16), _mm_unpackhi_epi8(first, second));
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        void b2h_ssse3(const std::uint8_t* b, std::size_t bsize, char* h)
+        {
+            b2h_blocks<he, 16>(b, bsize, h, b2h_block16<he>);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // каждая 128-битная половина v (для big - еще не развернутая) -> 32 символа, в h0 и h1 соответственно
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("avx2")
+        DCI_UTILS_CPU_INLINE void b2h_lanes(__m256i v, char* h0, char* h1)
+        {
+            if constexpr(HexEndian::big == he)
+                v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0,
+                                                            15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0));
+
+            const __m256i mask = _mm256_set1_epi8(0x0f);
+            const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)));
+            __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+            __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+
+            __m256i first  = HexEndian::little == he ? lo : hi;
+            __m256i second = HexEndian::little == he ? hi : lo;
+
+            // unpack работает внутри 128-битных половин, собираем порядок обратно
+            __m256i l = _mm256_unpacklo_epi8(first, second);
+            __m256i r = _mm256_unpackhi_epi8(first, second);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(h0), _mm256_permute2x128_si256(l, r, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(h1), _mm256_permute2x128_si256(l, r, 0x31));
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("avx2")
+        void b2h_avx2(const std::uint8_t* b, std::size_t bsize, char* h)
+        {
+            // остаток до 31 байта - еще одним 16-байтным шагом, затем по 4 байта (SWAR) и только потом
+            // скалярно, иначе 16..31-байтные входы (UUID, SHA-1 и т.п.) не попадают в SIMD вовсе
+            auto tail = [](const std::uint8_t* b, std::size_t bsize, char* h) DCI_UTILS_CPU_TARGET("avx2")
+            {
+                b2h_blocks<he, 16>(b, bsize, h, b2h_block16<he>, b2h_swar<he>);
+            };
+
+            b2h_blocks<he, 32>(b, bsize, h, [](const std::uint8_t* b, char* h) DCI_UTILS_CPU_TARGET("avx2")
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+                if constexpr(HexEndian::big == he)
+                    v = _mm256_permute4x64_epi64(v, 0x4e);
+
+                b2h_lanes<he>(v, h, h+32);
+            }, tail);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // два элемента пакета по 16..31 байт: их 16-байтные блоки кодируются в половинах одного ymm
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("avx2")
+        void b2h_pairAvx2(const std::uint8_t* b1, std::size_t bsize1, char* h1, const std::uint8_t* b2, std::size_t bsize2, char* h2)
+        {
+            const std::uint8_t* block1 = HexEndian::big == he ? b1 + bsize1 - 16 : b1;
+            const std::uint8_t* block2 = HexEndian::big == he ? b2 + bsize2 - 16 : b2;
+
+            __m256i v = _mm256_inserti128_si256(
+                            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block1))),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block2)),
+                            1);
+
+            b2h_lanes<he>(v, h1, h2);
+
+            if constexpr(HexEndian::big == he)
+            {
+                b2h_swar<he>(b1, bsize1 - 16, h1 + 32);
+                b2h_swar<he>(b2, bsize2 - 16, h2 + 32);
+            }
+            else
+            {
+                b2h_swar<he>(b1 + 16, bsize1 - 16, h1 + 32);
+                b2h_swar<he>(b2 + 16, bsize2 - 16, h2 + 32);
+            }
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        using Kernel = void (*)(const std::uint8_t* b, std::size_t bsize, char* h);
+
+        // два элемента пакета по 16..31 байт за раз, есть не у всех наборов
+        using PairKernel = void (*)(const std::uint8_t* b1, std::size_t bsize1, char* h1, const std::uint8_t* b2, std::size_t bsize2, char* h2);
+
+        struct Kernels
+        {
+            Kernel      _little;
+            Kernel      _middle;
+            Kernel      _big;
+            PairKernel  _littlePair{};
+            PairKernel  _middlePair{};
+            PairKernel  _bigPair{};
+        };
+
+        // все наборы, пригодные на этом процессоре, от лучшего к эталонному; первый - рабочий
+        const std::vector<Kernels>& variants()
+        {
+            static const std::vector<Kernels> res = []
+            {
+                std::vector<Kernels> res;
+#if DCI_UTILS_CPU_X86
+                const cpu::Features& f = cpu::features();
+                if(f._avx2)  res.push_back({b2h_avx2 <HexEndian::little>, b2h_avx2 <HexEndian::middle>, b2h_avx2 <HexEndian::big>,
+                                            b2h_pairAvx2<HexEndian::little>, b2h_pairAvx2<HexEndian::middle>, b2h_pairAvx2<HexEndian::big>});
+                if(f._ssse3) res.push_back({b2h_ssse3<HexEndian::little>, b2h_ssse3<HexEndian::middle>, b2h_ssse3<HexEndian::big>});
+                if(f._sse2)  res.push_back({b2h_sse2 <HexEndian::little>, b2h_sse2 <HexEndian::middle>, b2h_sse2 <HexEndian::big>});
+#endif
+                res.push_back({b2h_swar<HexEndian::little>, b2h_swar<HexEndian::middle>, b2h_swar<HexEndian::big>});
+                res.push_back({b2h_scalar<HexEndian::little>, b2h_scalar<HexEndian::middle>, b2h_scalar<HexEndian::big>});
+                return res;
+            }();
+
+            return res;
+        }
+
+        const Kernels& kernels()
+        {
+            static const Kernels& res = variants().front();
+            return res;
+        }
+
+        Kernel kernel(const Kernels& ks, HexEndian he)
+        {
+            switch(he)
+            {
+            case HexEndian::little:
+                return ks._little;
+            case HexEndian::middle:
+                return ks._middle;
+            case HexEndian::big:
+                return ks._big;
+            }
+
+            return ks._little;
+        }
+
+        Kernel kernel(HexEndian he)
+        {
+            return kernel(kernels(), he);
+        }
+
+        PairKernel pairKernel(const Kernels& ks, HexEndian he)
+        {
+            switch(he)
+            {
+            case HexEndian::little:
+                return ks._littlePair;
+            case HexEndian::middle:
+                return ks._middlePair;
+            case HexEndian::big:
+                return ks._bigPair;
+            }
+
+            return ks._littlePair;
+        }
+
+        bool pairable(std::size_t bsize)
+        {
+            return bsize >= 16 && bsize < 32;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // соседние элементы по 16..31 байт, если у набора есть парное ядро, кодируются попарно -
+        // иначе каждый из них заполняет вектор только наполовину
+        void b2hBatchImpl(const Kernels& ks, std::span<const B2hBatchItem> items, char* h, std::size_t* offsets, HexEndian he)
+        {
+            // ядро выбирается один раз на весь пакет
+            Kernel k = kernel(ks, he);
+            PairKernel pk = pairKernel(ks, he);
+
+            std::size_t pos{0};
+            for(std::size_t i{0}; i<items.size(); ++i)
             {
-                h[i*2+0] = dgt(b[bsize-1-i]>>4);
-                h[i*2+1] = dgt(b[bsize-1-i]&0xf);
+                const std::uint8_t* b1 = static_cast<const std::uint8_t *>(items[i].first);
+                std::size_t bsize1 = items[i].second;
+
+                if(offsets)
+                    offsets[i] = pos;
+
+                if(pk && pairable(bsize1) && i+1 < items.size() && pairable(items[i+1].second))
+                {
+                    std::size_t pos2 = pos + bsize1*2;
+                    std::size_t bsize2 = items[i+1].second;
+
+                    if(offsets)
+                        offsets[i+1] = pos2;
+
+                    pk(b1, bsize1, h + pos, static_cast<const std::uint8_t *>(items[i+1].first), bsize2, h + pos2);
+                    pos = pos2 + bsize2*2;
+                    ++i;
+                    continue;
+                }
+
+                k(b1, bsize1, h + pos);
+                pos += bsize1*2;
             }
+
+            if(offsets)
+                offsets[items.size()] = pos;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        void b2hBatchImpl(const Kernels& ks, const std::uint8_t* b, std::size_t itemSize, std::size_t stride, std::size_t count, char* h, HexEndian he)
+        {
+            Kernel k = kernel(ks, he);
+
+            // плотно уложенные элементы для little/middle неотличимы от одного большого буфера
+            if(stride == itemSize && HexEndian::big != he)
+                return k(b, itemSize*count, h);
+
+            std::size_t i{0};
+            if(PairKernel pk = pairKernel(ks, he); pk && pairable(itemSize))
+            {
+                for(; i+1 < count; i += 2)
+                    pk(b + i*stride, itemSize, h + i*itemSize*2, b + (i+1)*stride, itemSize, h + (i+1)*itemSize*2);
+            }
+
+            for(; i<count; ++i)
+                k(b + i*stride, itemSize, h + i*itemSize*2);
         }
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     void b2h(const void* b, std::size_t bsize, void* h, HexEndian he)
     {
+        kernel(he)(static_cast<const std::uint8_t *>(b), bsize, static_cast<char *>(h));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string b2h(const void* b, std::size_t bsize, HexEndian he)
+    {
+        std::string h;
+        h.resize(bsize*2);
+        b2h(b, bsize, h.data(), he);
+        return h;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void b2hParallel(const void* b, std::size_t bsize, void* h, HexEndian he, std::size_t serialThreshold)
+    {
+        if(bsize <= serialThreshold)
+            return b2h(b, bsize, h, he);
+
+        // кусок входа с выходом вдвое больше должен помещаться в L2
+        constexpr std::size_t chunkSize = 128*1024;
+
         const std::uint8_t* b_ = static_cast<const std::uint8_t *>(b);
         char* h_ = static_cast<char *>(h);
 
-        switch(he)
+        workers::parallelFor((bsize + chunkSize - 1) / chunkSize, [&](std::size_t index)
         {
-        case HexEndian::little:
-            return b2h_little(b_, bsize, h_);
-        case HexEndian::middle:
-            return b2h_middle(b_, bsize, h_);
-        case HexEndian::big:
-            return b2h_big(b_, bsize, h_);
-        }
+            std::size_t begin = index * chunkSize;
+            std::size_t size = std::min(chunkSize, bsize - begin);
+
+            // для big кусок [begin, begin+size) ложится в зеркальную позицию выхода
+            std::size_t hpos = HexEndian::big == he ? (bsize - begin - size)*2 : begin*2;
+            b2h(b_ + begin, size, h_ + hpos, he);
+        });
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    std::string b2h(const void* b, std::size_t bsize, HexEndian he)
+    void b2hBatch(std::span<const B2hBatchItem> items, void* h, std::size_t* offsets, HexEndian he)
+    {
+        b2hBatchImpl(kernels(), items, static_cast<char *>(h), offsets, he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string b2hBatch(std::span<const B2hBatchItem> items, std::vector<std::size_t>& offsets, HexEndian he)
     {
+        std::size_t hsize{0};
+        for(const B2hBatchItem& item : items)
+            hsize += item.second*2;
+
         std::string h;
-        h.resize(bsize*2);
-        b2h(b, bsize, h.data(), he);
+        h.resize(hsize);
+        offsets.resize(items.size()+1);
+        b2hBatch(items, h.data(), offsets.data(), he);
+        return h;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void b2hBatch(const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, void* h, HexEndian he)
+    {
+        b2hBatchImpl(kernels(), static_cast<const std::uint8_t *>(b), itemSize, stride, count, static_cast<char *>(h), he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string b2hBatch(const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, HexEndian he)
+    {
+        std::string h;
+        h.resize(itemSize*count*2);
+        b2hBatch(b, itemSize, stride, count, h.data(), he);
         return h;
     }
 }
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t b2hVariants()
+    {
+        return variants().size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void b2hVariant(std::size_t variant, const void* b, std::size_t bsize, void* h, HexEndian he)
+    {
+        kernel(variants().at(variant), he)(static_cast<const std::uint8_t *>(b), bsize, static_cast<char *>(h));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void b2hBatchVariant(std::size_t variant, std::span<const B2hBatchItem> items, void* h, std::size_t* offsets, HexEndian he)
+    {
+        b2hBatchImpl(variants().at(variant), items, static_cast<char *>(h), offsets, he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void b2hBatchVariant(std::size_t variant, const void* b, std::size_t itemSize, std::size_t stride, std::size_t count, void* h, HexEndian he)
+    {
+        b2hBatchImpl(variants().at(variant), static_cast<const std::uint8_t *>(b), itemSize, stride, count, static_cast<char *>(h), he);
+    }
+}
@@ -0,0 +1,182 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/base32.hpp>
+
+namespace dci::utils::base32
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        constexpr const char* digits = Alphabet::standard == a ?
+                                           "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567" :
+                                           "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+
+        constexpr std::uint8_t bad = 0xff;
+
+        template <Alphabet a>
+        constexpr std::array<std::uint8_t, 256> values = []
+        {
+            std::array<std::uint8_t, 256> res{};
+            res.fill(bad);
+
+            for(std::uint8_t i{0}; i<32; ++i)
+            {
+                char c = digits<a>[i];
+                res[static_cast<std::uint8_t>(c)] = i;
+                if(c >= 'A' && c <= 'Z')
+                    res[static_cast<std::uint8_t>(c - 'A' + 'a')] = i;
+            }
+
+            return res;
+        }();
+
+        // символов в неполной группе по числу байт в ней
+        constexpr std::size_t tailChars[5] = {0, 2, 4, 5, 7};
+
+        // байт в неполной группе по числу символов в ней, bad - недопустимая длина
+        constexpr std::size_t tailBytes[8] = {0, bad, 1, bad, 2, 3, bad, 4};
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        void encodeImpl(const std::uint8_t* b, std::size_t bsize, char* t, bool pad)
+        {
+            // группа 5 байт собирается в 40-битное слово и раскладывается на 8 символов
+            auto group = [&](const std::uint8_t* b, std::size_t size, char* t)
+            {
+                std::uint64_t v{};
+                for(std::size_t i{}; i<5; ++i)
+                    v = v << 8 | (i < size ? b[i] : 0u);
+
+                for(std::size_t i{}; i<8; ++i)
+                    t[i] = digits<a>[(v >> (35 - i*5)) & 0x1f];
+            };
+
+            std::size_t done{0};
+            for(; done+5 <= bsize; done += 5, t += 8)
+                group(b+done, 5, t);
+
+            if(std::size_t rest = bsize - done)
+            {
+                char buf[8];
+                group(b+done, rest, buf);
+                std::size_t chars = tailChars[rest];
+                std::memcpy(t, buf, chars);
+                if(pad)
+                    std::memset(t+chars, '=', 8-chars);
+            }
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        bool decodeImpl(const char* t, std::size_t tsize, std::uint8_t* b, std::size_t& bsize)
+        {
+            if(tsize && '=' == t[tsize-1])
+            {
+                if(tsize & 7)
+                    return false;
+
+                // в неполной группе не меньше двух значащих символов
+                for(std::size_t i{}; i<6 && '=' == t[tsize-1]; ++i)
+                    --tsize;
+            }
+
+            std::size_t rest = tsize & 7;
+            if(bad == tailBytes[rest])
+                return false;
+
+            bsize = tsize/8*5 + tailBytes[rest];
+
+            auto group = [&](const char* t, std::size_t size, std::uint8_t* b, std::size_t bytes)
+            {
+                std::uint64_t v{};
+                std::uint8_t check{};
+                for(std::size_t i{}; i<8; ++i)
+                {
+                    std::uint8_t d = i < size ? values<a>[static_cast<std::uint8_t>(t[i])] : 0;
+                    check |= d;
+                    v = v << 5 | d;
+                }
+
+                if(check & 0xe0)
+                    return false;
+
+                for(std::size_t i{}; i<bytes; ++i)
+                    b[i] = static_cast<std::uint8_t>(v >> (32 - i*8));
+
+                return true;
+            };
+
+            std::size_t done{0};
+            for(; done+8 <= tsize; done += 8, b += 5)
+                if(!group(t+done, 8, b, 5))
+                    return false;
+
+            if(rest)
+                return group(t+done, rest, b, tailBytes[rest]);
+
+            return true;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t encodedSize(std::size_t bsize, bool pad)
+    {
+        if(pad)
+            return (bsize+4)/5*8;
+
+        return bsize/5*8 + tailChars[bsize%5];
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void encode(const void* b, std::size_t bsize, void* t, Alphabet a, bool pad)
+    {
+        const std::uint8_t* b_ = static_cast<const std::uint8_t *>(b);
+        char* t_ = static_cast<char *>(t);
+
+        switch(a)
+        {
+        case Alphabet::standard:
+            return encodeImpl<Alphabet::standard>(b_, bsize, t_, pad);
+        case Alphabet::hex:
+            return encodeImpl<Alphabet::hex>(b_, bsize, t_, pad);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string encode(const void* b, std::size_t bsize, Alphabet a, bool pad)
+    {
+        std::string t;
+        t.resize(encodedSize(bsize, pad));
+        encode(b, bsize, t.data(), a, pad);
+        return t;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t decodedSize(std::size_t tsize)
+    {
+        return (tsize+7)/8*5;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool decode(const void* t, std::size_t tsize, void* b, std::size_t& bsize, Alphabet a)
+    {
+        const char* t_ = static_cast<const char *>(t);
+        std::uint8_t* b_ = static_cast<std::uint8_t *>(b);
+
+        switch(a)
+        {
+        case Alphabet::standard:
+            return decodeImpl<Alphabet::standard>(t_, tsize, b_, bsize);
+        case Alphabet::hex:
+            return decodeImpl<Alphabet::hex>(t_, tsize, b_, bsize);
+        }
+
+        return false;
+    }
+}
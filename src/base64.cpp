@@ -0,0 +1,469 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/base64.hpp>
+#include "cpu.hpp"
+
+namespace dci::utils::base64
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        constexpr const char* digits = Alphabet::standard == a ?
+                                           "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" :
+                                           "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        constexpr std::uint8_t bad = 0xff;
+
+        template <Alphabet a>
+        constexpr std::array<std::uint8_t, 256> values = []
+        {
+            std::array<std::uint8_t, 256> res{};
+            res.fill(bad);
+
+            for(std::uint8_t i{0}; i<64; ++i)
+                res[static_cast<std::uint8_t>(digits<a>[i])] = i;
+
+            return res;
+        }();
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // SIMD-ядра обрабатывают основную часть и возвращают сколько входа потреблено, остаток добирается скалярно
+        using EncodeKernel = std::size_t (*)(const std::uint8_t* b, std::size_t bsize, char* t);
+        using DecodeKernel = std::size_t (*)(const char* t, std::size_t tsize, std::uint8_t* b, bool& ok);
+
+        std::size_t encodeNone(const std::uint8_t*, std::size_t, char*)
+        {
+            return 0;
+        }
+
+        std::size_t decodeNone(const char*, std::size_t, std::uint8_t*, bool&)
+        {
+            return 0;
+        }
+
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // алгоритм W. Muła, D. Lemire: 12 байт в каждой 128-битной дорожке -> 16 индексов по 6 бит -> 16 символов
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE __m128i encodeIndices(__m128i in)
+        {
+            in = _mm_shuffle_epi8(in, _mm_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1));
+            __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+            __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+            return _mm_or_si128(hi, lo);
+        }
+
+        // смещение символа относительно индекса, выбирается по классу индекса: a-z, 0-9, c62, c63, A-Z
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE __m128i encodeShifts()
+        {
+            constexpr char c62 = digits<a>[62];
+            constexpr char c63 = digits<a>[63];
+
+            return _mm_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+                                 '0'-52, '0'-52, '0'-52, c62-62, c63-63, 'A', 0, 0);
+        }
+
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE __m128i encodeChars(__m128i indices)
+        {
+            __m128i cls = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            cls = _mm_or_si128(cls, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+            return _mm_add_epi8(_mm_shuffle_epi8(encodeShifts<a>(), cls), indices);
+        }
+
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("avx2")
+        DCI_UTILS_CPU_INLINE __m256i encodeChars(__m256i in)
+        {
+            in = _mm256_shuffle_epi8(in, _mm256_broadcastsi128_si256(_mm_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1)));
+            __m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+            __m256i lo = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+            __m256i indices = _mm256_or_si256(hi, lo);
+
+            __m256i cls = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            cls = _mm256_or_si256(cls, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+            return _mm256_add_epi8(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(encodeShifts<a>()), cls), indices);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // символы -> значения 0..63 через проверки диапазонов; invalid - маска недопустимых символов
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE __m128i decodeValues(__m128i v, int& invalid)
+        {
+            constexpr char c62 = digits<a>[62];
+            constexpr char c63 = digits<a>[63];
+
+            __m128i d;
+            d = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+            __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(25)), d);
+            d = _mm_sub_epi8(v, _mm_set1_epi8('a'));
+            __m128i lower = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(25)), d);
+            d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+            __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+            __m128i is62 = _mm_cmpeq_epi8(v, _mm_set1_epi8(c62));
+            __m128i is63 = _mm_cmpeq_epi8(v, _mm_set1_epi8(c63));
+
+            invalid = 0xffff ^ _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, is62)), is63));
+
+            __m128i shift =                   _mm_and_si128(upper, _mm_set1_epi8(static_cast<char>(-'A')));
+            shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(static_cast<char>(26-'a'))));
+            shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(static_cast<char>(52-'0'))));
+            shift = _mm_or_si128(shift, _mm_and_si128(is62,  _mm_set1_epi8(static_cast<char>(62-c62))));
+            shift = _mm_or_si128(shift, _mm_and_si128(is63,  _mm_set1_epi8(static_cast<char>(63-c63))));
+
+            return _mm_add_epi8(v, shift);
+        }
+
+        // 16 значений по 6 бит -> 12 байт в начале
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE __m128i decodePack(__m128i values)
+        {
+            __m128i t = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            t = _mm_madd_epi16(t, _mm_set1_epi32(0x00011000));
+            return _mm_shuffle_epi8(t, _mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1));
+        }
+
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("avx2")
+        DCI_UTILS_CPU_INLINE __m256i decodeValues(__m256i v, int& invalid)
+        {
+            constexpr char c62 = digits<a>[62];
+            constexpr char c63 = digits<a>[63];
+
+            __m256i d;
+            d = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+            __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(25)), d);
+            d = _mm256_sub_epi8(v, _mm256_set1_epi8('a'));
+            __m256i lower = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(25)), d);
+            d = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+            __m256i digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+            __m256i is62 = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c62));
+            __m256i is63 = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c63));
+
+            invalid = ~_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, is62)), is63));
+
+            __m256i shift =                      _mm256_and_si256(upper, _mm256_set1_epi8(static_cast<char>(-'A')));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(static_cast<char>(26-'a'))));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(static_cast<char>(52-'0'))));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(is62,  _mm256_set1_epi8(static_cast<char>(62-c62))));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(is63,  _mm256_set1_epi8(static_cast<char>(63-c63))));
+
+            return _mm256_add_epi8(v, shift);
+        }
+
+        // по 12 байт в начале каждой дорожки, затем сведение в 24 подряд
+        DCI_UTILS_CPU_TARGET("avx2")
+        DCI_UTILS_CPU_INLINE __m256i decodePack(__m256i values)
+        {
+            __m256i t = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            t = _mm256_madd_epi16(t, _mm256_set1_epi32(0x00011000));
+            t = _mm256_shuffle_epi8(t, _mm256_broadcastsi128_si256(_mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1)));
+            return _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0,1,2, 4,5,6, 3,7));
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        std::size_t encodeSsse3(const std::uint8_t* b, std::size_t bsize, char* t)
+        {
+            // читается 16 байт, используется 12
+            std::size_t done{0};
+            for(; done+16 <= bsize; done += 12, t += 16)
+            {
+                __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+done));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(t), encodeChars<a>(encodeIndices(in)));
+            }
+
+            return done;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("avx2")
+        std::size_t encodeAvx2(const std::uint8_t* b, std::size_t bsize, char* t)
+        {
+            // дорожки читаются с b и b+12, нужно 28 байт, используется 24
+            std::size_t done{0};
+            for(; done+28 <= bsize; done += 24, t += 32)
+            {
+                __m256i in = _mm256_inserti128_si256(
+                                 _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b+done))),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+done+12)),
+                                 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(t), encodeChars<a>(in));
+            }
+
+            return done;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        std::size_t decodeSsse3(const char* t, std::size_t tsize, std::uint8_t* b, bool& ok)
+        {
+            // пишется 16 байт, полезных 12; запас в 8 символов не дает записи выйти за результат
+            std::size_t done{0};
+            for(; done+24 <= tsize; done += 16, b += 12)
+            {
+                int invalid;
+                __m128i values = decodeValues<a>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t+done)), invalid);
+                if(invalid)
+                {
+                    ok = false;
+                    return done;
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(b), decodePack(values));
+            }
+
+            return done;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        DCI_UTILS_CPU_TARGET("avx2")
+        std::size_t decodeAvx2(const char* t, std::size_t tsize, std::uint8_t* b, bool& ok)
+        {
+            // пишется 32 байта, полезных 24
+            std::size_t done{0};
+            for(; done+48 <= tsize; done += 32, b += 24)
+            {
+                int invalid;
+                __m256i values = decodeValues<a>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(t+done)), invalid);
+                if(invalid)
+                {
+                    ok = false;
+                    return done;
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(b), decodePack(values));
+            }
+
+            return done;
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        struct Kernels
+        {
+            EncodeKernel _encodeStandard;
+            EncodeKernel _encodeUrl;
+            DecodeKernel _decodeStandard;
+            DecodeKernel _decodeUrl;
+        };
+
+        // все наборы, пригодные на этом процессоре, от лучшего к скалярному; первый - рабочий
+        const std::vector<Kernels>& variants()
+        {
+            static const std::vector<Kernels> res = []
+            {
+                std::vector<Kernels> res;
+#if DCI_UTILS_CPU_X86
+                const cpu::Features& f = cpu::features();
+                if(f._avx2)  res.push_back({encodeAvx2 <Alphabet::standard>, encodeAvx2 <Alphabet::url>, decodeAvx2 <Alphabet::standard>, decodeAvx2 <Alphabet::url>});
+                if(f._ssse3) res.push_back({encodeSsse3<Alphabet::standard>, encodeSsse3<Alphabet::url>, decodeSsse3<Alphabet::standard>, decodeSsse3<Alphabet::url>});
+#endif
+                res.push_back({encodeNone, encodeNone, decodeNone, decodeNone});
+                return res;
+            }();
+
+            return res;
+        }
+
+        const Kernels& kernels()
+        {
+            static const Kernels& res = variants().front();
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        void encodeImpl(const std::uint8_t* b, std::size_t bsize, char* t, bool pad, EncodeKernel kernel)
+        {
+            std::size_t done = kernel(b, bsize, t);
+            t += done/3*4;
+
+            for(; done+3 <= bsize; done += 3, t += 4)
+            {
+                std::uint32_t v = static_cast<std::uint32_t>(b[done]<<16 | b[done+1]<<8 | b[done+2]);
+                t[0] = digits<a>[(v >> 18) & 0x3f];
+                t[1] = digits<a>[(v >> 12) & 0x3f];
+                t[2] = digits<a>[(v >>  6) & 0x3f];
+                t[3] = digits<a>[(v >>  0) & 0x3f];
+            }
+
+            switch(bsize - done)
+            {
+            case 1:
+                t[0] = digits<a>[b[done] >> 2];
+                t[1] = digits<a>[(b[done] & 0x03) << 4];
+                if(pad)
+                {
+                    t[2] = '=';
+                    t[3] = '=';
+                }
+                break;
+
+            case 2:
+                t[0] = digits<a>[b[done] >> 2];
+                t[1] = digits<a>[((b[done] & 0x03) << 4) | (b[done+1] >> 4)];
+                t[2] = digits<a>[(b[done+1] & 0x0f) << 2];
+                if(pad)
+                    t[3] = '=';
+                break;
+            }
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <Alphabet a>
+        bool decodeImpl(const char* t, std::size_t tsize, std::uint8_t* b, std::size_t& bsize, DecodeKernel kernel)
+        {
+            if(tsize && '=' == t[tsize-1])
+            {
+                if(tsize & 3)
+                    return false;
+
+                tsize -= ('=' == t[tsize-2]) ? 2 : 1;
+            }
+
+            if(1 == (tsize & 3))
+                return false;
+
+            bsize = tsize/4*3 + (tsize & 3 ? (tsize & 3) - 1 : 0);
+
+            bool ok{true};
+            std::size_t done = kernel(t, tsize, b, ok);
+            if(!ok)
+                return false;
+            b += done/4*3;
+
+            auto value = [&](char c)
+            {
+                return values<a>[static_cast<std::uint8_t>(c)];
+            };
+
+            for(; done+4 <= tsize; done += 4, b += 3)
+            {
+                std::uint8_t v0 = value(t[done+0]);
+                std::uint8_t v1 = value(t[done+1]);
+                std::uint8_t v2 = value(t[done+2]);
+                std::uint8_t v3 = value(t[done+3]);
+                if((v0 | v1 | v2 | v3) & 0xc0)
+                    return false;
+
+                std::uint32_t v = static_cast<std::uint32_t>(v0<<18 | v1<<12 | v2<<6 | v3);
+                b[0] = static_cast<std::uint8_t>(v >> 16);
+                b[1] = static_cast<std::uint8_t>(v >>  8);
+                b[2] = static_cast<std::uint8_t>(v >>  0);
+            }
+
+            if(tsize - done >= 2)
+            {
+                std::uint8_t v0 = value(t[done+0]);
+                std::uint8_t v1 = value(t[done+1]);
+                std::uint8_t v2 = tsize - done == 3 ? value(t[done+2]) : 0;
+                if((v0 | v1 | v2) & 0xc0)
+                    return false;
+
+                b[0] = static_cast<std::uint8_t>(v0<<2 | v1>>4);
+                if(tsize - done == 3)
+                    b[1] = static_cast<std::uint8_t>(v1<<4 | v2>>2);
+            }
+
+            return true;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        void encodeImpl(const Kernels& ks, const std::uint8_t* b, std::size_t bsize, char* t, Alphabet a, bool pad)
+        {
+            switch(a)
+            {
+            case Alphabet::standard:
+                return encodeImpl<Alphabet::standard>(b, bsize, t, pad, ks._encodeStandard);
+            case Alphabet::url:
+                return encodeImpl<Alphabet::url>(b, bsize, t, pad, ks._encodeUrl);
+            }
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        bool decodeImpl(const Kernels& ks, const char* t, std::size_t tsize, std::uint8_t* b, std::size_t& bsize, Alphabet a)
+        {
+            switch(a)
+            {
+            case Alphabet::standard:
+                return decodeImpl<Alphabet::standard>(t, tsize, b, bsize, ks._decodeStandard);
+            case Alphabet::url:
+                return decodeImpl<Alphabet::url>(t, tsize, b, bsize, ks._decodeUrl);
+            }
+
+            return false;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t encodedSize(std::size_t bsize, bool pad)
+    {
+        if(pad)
+            return (bsize+2)/3*4;
+
+        return bsize/3*4 + (bsize%3 ? bsize%3 + 1 : 0);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void encode(const void* b, std::size_t bsize, void* t, Alphabet a, bool pad)
+    {
+        encodeImpl(kernels(), static_cast<const std::uint8_t *>(b), bsize, static_cast<char *>(t), a, pad);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string encode(const void* b, std::size_t bsize, Alphabet a, bool pad)
+    {
+        std::string t;
+        t.resize(encodedSize(bsize, pad));
+        encode(b, bsize, t.data(), a, pad);
+        return t;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t decodedSize(std::size_t tsize)
+    {
+        return (tsize+3)/4*3;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool decode(const void* t, std::size_t tsize, void* b, std::size_t& bsize, Alphabet a)
+    {
+        return decodeImpl(kernels(), static_cast<const char *>(t), tsize, static_cast<std::uint8_t *>(b), bsize, a);
+    }
+}
+
+namespace dci::utils::base64::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t variants()
+    {
+        return base64::variants().size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void encodeVariant(std::size_t variant, const void* b, std::size_t bsize, void* t, Alphabet a, bool pad)
+    {
+        encodeImpl(base64::variants().at(variant), static_cast<const std::uint8_t *>(b), bsize, static_cast<char *>(t), a, pad);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool decodeVariant(std::size_t variant, const void* t, std::size_t tsize, void* b, std::size_t& bsize, Alphabet a)
+    {
+        return decodeImpl(base64::variants().at(variant), static_cast<const char *>(t), tsize, static_cast<std::uint8_t *>(b), bsize, a);
+    }
+}
@@ -0,0 +1,138 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include "charScan.hpp"
+#include "cpu.hpp"
+#include <bit>
+
+namespace dci::utils::charScan
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // stop - значение принадлежности set, на котором поиск останавливается
+        template <bool stop>
+        const char* scanScalar(const char* p, const char* e, const Set& set)
+        {
+            while(p != e && set.contains(*p) != stop)
+                ++p;
+            return p;
+        }
+
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // битовая маска байт блока, не входящих в set
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE unsigned outsiders(__m128i v, __m128i lo, __m128i hi)
+        {
+            const __m128i nibble = _mm_set1_epi8(0x0f);
+            __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, nibble));
+            __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(l, h), _mm_setzero_si128())));
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <bool stop>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        DCI_UTILS_CPU_INLINE const char* block16(const char*& p, const char* e, __m128i lo, __m128i hi)
+        {
+            for(; e - p >= 16; p += 16)
+            {
+                unsigned mask = outsiders(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), lo, hi);
+                if constexpr(stop)
+                    mask ^= 0xffff;
+                if(mask)
+                    return p + std::countr_zero(mask);
+            }
+
+            return nullptr;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <bool stop>
+        DCI_UTILS_CPU_TARGET("ssse3")
+        const char* scanSsse3(const char* p, const char* e, const Set& set)
+        {
+            const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(set._lo));
+            const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(set._hi));
+
+            if(const char* res = block16<stop>(p, e, lo, hi))
+                return res;
+
+            return scanScalar<stop>(p, e, set);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <bool stop>
+        DCI_UTILS_CPU_TARGET("avx2")
+        const char* scanAvx2(const char* p, const char* e, const Set& set)
+        {
+            const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(set._lo));
+            const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(set._hi));
+
+            // pshufb в ymm работает по 128-битным половинам, таблицы дублируются в обе
+            const __m256i lo2 = _mm256_broadcastsi128_si256(lo);
+            const __m256i hi2 = _mm256_broadcastsi128_si256(hi);
+            const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+            for(; e - p >= 32; p += 32)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                __m256i l = _mm256_shuffle_epi8(lo2, _mm256_and_si256(v, nibble));
+                __m256i h = _mm256_shuffle_epi8(hi2, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(l, h), _mm256_setzero_si256())));
+                if constexpr(stop)
+                    mask = ~mask;
+                if(mask)
+                    return p + std::countr_zero(mask);
+            }
+
+            if(const char* res = block16<stop>(p, e, lo, hi))
+                return res;
+
+            return scanScalar<stop>(p, e, set);
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        using Kernel = const char* (*)(const char* p, const char* e, const Set& set);
+
+        struct Kernels
+        {
+            Kernel _skip;
+            Kernel _find;
+        };
+
+        const Kernels& kernels()
+        {
+            static const Kernels res = []() -> Kernels
+            {
+#if DCI_UTILS_CPU_X86
+                const cpu::Features& f = cpu::features();
+                if(f._avx2)  return {scanAvx2<false>, scanAvx2<true>};
+                if(f._ssse3) return {scanSsse3<false>, scanSsse3<true>};
+#endif
+                return {scanScalar<false>, scanScalar<true>};
+            }();
+
+            return res;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    const char* skip(const char* p, const char* e, const Set& set)
+    {
+        return kernels()._skip(p, e, set);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    const char* find(const char* p, const char* e, const Set& set)
+    {
+        return kernels()._find(p, e, set);
+    }
+}
@@ -0,0 +1,52 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace dci::utils::charScan
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // множество ASCII-символов в виде двух таблиц по полубайтам: c входит в множество, если
+    // lo[c & 0xf] & hi[c >> 4] != 0, где hi[h] = 1 << h, а для c >= 0x80 hi - ноль.
+    // В таком виде принадлежность проверяется парой pshufb сразу для 16/32 байт
+    struct Set
+    {
+        alignas(16) std::uint8_t _lo[16]{};
+        alignas(16) std::uint8_t _hi[16]{1, 2, 4, 8, 16, 32, 64, 128};
+
+        constexpr Set() = default;
+
+        constexpr explicit Set(std::string_view chars)
+        {
+            for(char c : chars)
+                add(c);
+        }
+
+        constexpr void add(char c)
+        {
+            std::uint8_t u = static_cast<std::uint8_t>(c);
+            if(u < 0x80)
+                _lo[u & 0xf] |= static_cast<std::uint8_t>(1u << (u >> 4));
+        }
+
+        constexpr bool contains(char c) const
+        {
+            std::uint8_t u = static_cast<std::uint8_t>(c);
+            return _lo[u & 0xf] & _hi[u >> 4];
+        }
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // первая позиция в [p, e), символ в которой не входит в set, либо e
+    const char* skip(const char* p, const char* e, const Set& set);
+
+    // первая позиция в [p, e), символ в которой входит в set, либо e
+    const char* find(const char* p, const char* e, const Set& set);
+}
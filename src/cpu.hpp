@@ -0,0 +1,57 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define DCI_UTILS_CPU_X86 1
+#   define DCI_UTILS_CPU_TARGET(isa) __attribute__((target(isa)))
+#   define DCI_UTILS_CPU_INLINE __attribute__((always_inline)) inline
+#   include <immintrin.h>
+#else
+#   define DCI_UTILS_CPU_X86 0
+#   define DCI_UTILS_CPU_TARGET(isa)
+#   define DCI_UTILS_CPU_INLINE inline
+#endif
+
+namespace dci::utils::cpu
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // набор расширений, определяется один раз при первом обращении (обычно при загрузке библиотеки)
+    struct Features
+    {
+        bool _sse2      {};
+        bool _ssse3     {};
+        bool _sse42     {};
+        bool _pclmul    {};
+        bool _avx2      {};
+        bool _avx512f   {};
+        bool _avx512bw  {};
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    inline const Features& features()
+    {
+        static const Features res = []
+        {
+            Features res;
+#if DCI_UTILS_CPU_X86
+            __builtin_cpu_init();
+            res._sse2       = __builtin_cpu_supports("sse2");
+            res._ssse3      = __builtin_cpu_supports("ssse3");
+            res._sse42      = __builtin_cpu_supports("sse4.2");
+            res._pclmul     = __builtin_cpu_supports("pclmul");
+            res._avx2       = __builtin_cpu_supports("avx2");
+            res._avx512f    = __builtin_cpu_supports("avx512f");
+            res._avx512bw   = __builtin_cpu_supports("avx512bw");
+#endif
+            return res;
+        }();
+
+        return res;
+    }
+}
@@ -0,0 +1,198 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/crc32c.hpp>
+#include "cpu.hpp"
+#include <cstring>
+#include <array>
+#include <vector>
+
+namespace dci::utils
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // состояние без начальной/конечной инверсии, отраженный порядок бит
+        using Kernel = std::uint32_t (*)(std::uint32_t state, const std::uint8_t* data, std::size_t size);
+
+        // 0x1EDC6F41 в отраженном виде
+        constexpr std::uint32_t poly = 0x82f63b78;
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // slicing-by-8: table[t][v] - вклад байта v, за которым следует еще t байт
+        using Table = std::array<std::array<std::uint32_t, 256>, 8>;
+
+        constexpr Table table = []
+        {
+            Table res{};
+            for(std::uint32_t v{0}; v<256; ++v)
+            {
+                std::uint32_t c = v;
+                for(int k{0}; k<8; ++k)
+                    c = (c >> 1) ^ (c & 1 ? poly : 0);
+                res[0][v] = c;
+            }
+
+            for(std::size_t t{1}; t<8; ++t)
+                for(std::size_t v{0}; v<256; ++v)
+                    res[t][v] = (res[t-1][v] >> 8) ^ res[0][res[t-1][v] & 0xff];
+
+            return res;
+        }();
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        std::uint32_t load32(const std::uint8_t* p)
+        {
+            return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+                   static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+        }
+
+        std::uint32_t updateTable(std::uint32_t state, const std::uint8_t* data, std::size_t size)
+        {
+            for(; size >= 8; data += 8, size -= 8)
+            {
+                std::uint32_t lo = load32(data) ^ state;
+                std::uint32_t hi = load32(data + 4);
+
+                state = table[7][lo & 0xff] ^ table[6][(lo >> 8) & 0xff] ^ table[5][(lo >> 16) & 0xff] ^ table[4][lo >> 24] ^
+                        table[3][hi & 0xff] ^ table[2][(hi >> 8) & 0xff] ^ table[1][(hi >> 16) & 0xff] ^ table[0][hi >> 24];
+            }
+
+            for(; size; ++data, --size)
+                state = (state >> 8) ^ table[0][(state ^ *data) & 0xff];
+
+            return state;
+        }
+
+#if DCI_UTILS_CPU_X86 && defined(__x86_64__)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        std::uint64_t load64(const std::uint8_t* p)
+        {
+            std::uint64_t res;
+            std::memcpy(&res, p, 8);
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        DCI_UTILS_CPU_TARGET("sse4.2")
+        std::uint32_t tail(std::uint64_t state, const std::uint8_t* data, std::size_t size)
+        {
+            for(; size >= 8; data += 8, size -= 8)
+                state = _mm_crc32_u64(state, load64(data));
+
+            std::uint32_t res = static_cast<std::uint32_t>(state);
+            for(; size; ++data, --size)
+                res = _mm_crc32_u8(res, *data);
+
+            return res;
+        }
+
+        DCI_UTILS_CPU_TARGET("sse4.2")
+        std::uint32_t updateSse42(std::uint32_t state, const std::uint8_t* data, std::size_t size)
+        {
+            return tail(state, data, size);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // x^n mod P в отраженном виде
+        constexpr std::uint64_t xpow(std::size_t n)
+        {
+            std::uint32_t res = 0x80000000;
+            for(std::size_t i{0}; i<n; ++i)
+                res = (res >> 1) ^ (res & 1 ? poly : 0);
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // Блоки по 3*len байт считаются тремя независимыми цепочками crc32 (у инструкции задержка 3 такта
+        // при пропускной способности 1), затем цепочки сводятся: сдвиг состояния на n нулевых байт - это
+        // умножение на x^(8n) mod P, делается одним pclmul и одним crc32 над произведением
+        // (crc32_u64(0, clmul(a, k)) == a*k*x^33 mod P, поэтому k = x^(8n-33))
+        template <std::size_t len>
+        DCI_UTILS_CPU_TARGET("sse4.2,pclmul")
+        std::uint64_t stripes(std::uint64_t state, const std::uint8_t*& data, std::size_t& size)
+        {
+            static_assert(len % 8 == 0);
+            const __m128i k = _mm_set_epi64x(static_cast<long long>(xpow(len*8-33)), static_cast<long long>(xpow(len*16-33)));
+
+            for(; size >= len*3; data += len*3, size -= len*3)
+            {
+                std::uint64_t a = state, b = 0, c = 0;
+                for(std::size_t i{0}; i<len; i += 8)
+                {
+                    a = _mm_crc32_u64(a, load64(data + i));
+                    b = _mm_crc32_u64(b, load64(data + len + i));
+                    c = _mm_crc32_u64(c, load64(data + len*2 + i));
+                }
+
+                __m128i ab = _mm_xor_si128(
+                    _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(a)), k, 0x00),
+                    _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(b)), k, 0x10));
+
+                state = _mm_crc32_u64(0, static_cast<std::uint64_t>(_mm_cvtsi128_si64(ab))) ^ c;
+            }
+
+            return state;
+        }
+
+        DCI_UTILS_CPU_TARGET("sse4.2,pclmul")
+        std::uint32_t updatePclmul(std::uint32_t state, const std::uint8_t* data, std::size_t size)
+        {
+            std::uint64_t s = state;
+            s = stripes<1024>(s, data, size);
+            s = stripes<128>(s, data, size);
+            return tail(s, data, size);
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // все ядра, пригодные на этом процессоре, от лучшего к табличному; первое - рабочее
+        const std::vector<Kernel>& variants()
+        {
+            static const std::vector<Kernel> res = []
+            {
+                std::vector<Kernel> res;
+#if DCI_UTILS_CPU_X86 && defined(__x86_64__)
+                const cpu::Features& f = cpu::features();
+                if(f._sse42 && f._pclmul)   res.push_back(updatePclmul);
+                if(f._sse42)                res.push_back(updateSse42);
+#endif
+                res.push_back(updateTable);
+                return res;
+            }();
+
+            return res;
+        }
+
+        Kernel kernel()
+        {
+            static const Kernel res = variants().front();
+            return res;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc)
+    {
+        return ~kernel()(~crc, static_cast<const std::uint8_t*>(data), size);
+    }
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t crc32cVariants()
+    {
+        return variants().size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::uint32_t crc32cVariant(std::size_t variant, const void* data, std::size_t size, std::uint32_t crc)
+    {
+        return ~variants().at(variant)(~crc, static_cast<const std::uint8_t*>(data), size);
+    }
+}
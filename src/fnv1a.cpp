@@ -0,0 +1,218 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/fnv1a.hpp>
+#include "cpu.hpp"
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace dci::utils
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // обрабатывает начало keys кратное ширине ядра, возвращает сколько ключей обработано
+        using Kernel = std::size_t (*)(const std::string_view* keys, std::size_t count, std::uint64_t* digests);
+
+        std::size_t batchNone(const std::string_view*, std::size_t, std::uint64_t*)
+        {
+            return 0;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // очередные 8 байт ключа с позиции pos, за концом ключа - нули (такие дорожки все равно неактивны)
+        std::uint64_t word(std::string_view key, std::size_t pos)
+        {
+            std::uint64_t res{0};
+            if(pos < key.size())
+                std::memcpy(&res, key.data() + pos, std::min<std::size_t>(8, key.size() - pos));
+            return res;
+        }
+
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // Состояние дорожек живет в памяти между шагами, чтобы векторные типы не пересекали границу
+        // обобщенного кода без target-атрибута; после встраивания компилятор держит его в регистре.
+        // Шаг - 8 байт words для каждой дорожки, дорожки где lens <= pos+j не меняются.
+        // prime = 2^40 + 0x1b3, поэтому умножение на него - два 32-битных умножения и сдвиги.
+        struct Avx2
+        {
+            static constexpr std::size_t _lanes = 4;
+
+            DCI_UTILS_CPU_TARGET("avx2")
+            static void step(std::uint64_t* state, const std::uint64_t* words, const std::uint64_t* lens, std::size_t pos)
+            {
+                const __m256i prime = _mm256_set1_epi64x(0x1b3);
+                const __m256i low = _mm256_set1_epi64x(0xff);
+                const __m256i sign = _mm256_set1_epi64x(std::is_signed_v<char> ? 0x80 : 0);
+
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state));
+                __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+                __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lens));
+
+                for(std::size_t j{0}; j<8; ++j, w = _mm256_srli_epi64(w, 8))
+                {
+                    // fnv1a<char> расширяет char до uint64_t со знаком
+                    __m256i c = _mm256_sub_epi64(_mm256_xor_si256(_mm256_and_si256(w, low), sign), sign);
+
+                    __m256i x = _mm256_xor_si256(s, c);
+                    __m256i lo = _mm256_mul_epu32(x, prime);
+                    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+                    x = _mm256_add_epi64(_mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)), _mm256_slli_epi64(x, 40));
+
+                    s = _mm256_blendv_epi8(s, x, _mm256_cmpgt_epi64(l, _mm256_set1_epi64x(static_cast<long long>(pos+j))));
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(state), s);
+            }
+        };
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        struct Avx512
+        {
+            static constexpr std::size_t _lanes = 8;
+
+            DCI_UTILS_CPU_TARGET("avx512f")
+            static void step(std::uint64_t* state, const std::uint64_t* words, const std::uint64_t* lens, std::size_t pos)
+            {
+                const __m512i prime = _mm512_set1_epi64(0x1b3);
+                const __m512i low = _mm512_set1_epi64(0xff);
+                const __m512i sign = _mm512_set1_epi64(std::is_signed_v<char> ? 0x80 : 0);
+
+                __m512i s = _mm512_loadu_si512(state);
+                __m512i w = _mm512_loadu_si512(words);
+                __m512i l = _mm512_loadu_si512(lens);
+
+                // сдвиги и умножение - в masked-форме: безмасочные берут неопределенный
+                // исходный вектор, и GCC 12 предупреждает о нем (-Wmaybe-uninitialized).
+                // Маска живых дорожек заодно заменяет blend в конце шага
+                for(std::size_t j{0}; j<8; ++j, w = _mm512_maskz_srli_epi64(static_cast<__mmask8>(0xff), w, 8))
+                {
+                    __mmask8 live = _mm512_cmpgt_epu64_mask(l, _mm512_set1_epi64(static_cast<long long>(pos+j)));
+
+                    __m512i c = _mm512_sub_epi64(_mm512_xor_si512(_mm512_and_si512(w, low), sign), sign);
+
+                    __m512i x = _mm512_xor_si512(s, c);
+                    __m512i lo = _mm512_maskz_mul_epu32(live, x, prime);
+                    __m512i hi = _mm512_maskz_mul_epu32(live, _mm512_maskz_srli_epi64(live, x, 32), prime);
+
+                    s = _mm512_mask_add_epi64(s, live,
+                                              _mm512_add_epi64(lo, _mm512_maskz_slli_epi64(live, hi, 32)),
+                                              _mm512_maskz_slli_epi64(live, x, 40));
+                }
+
+                _mm512_storeu_si512(state, s);
+            }
+        };
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // группы по Ops::_lanes ключей, по 8 байт каждого ключа за шаг
+        template <class Ops>
+        DCI_UTILS_CPU_INLINE std::size_t batchBlocks(const std::string_view* keys, std::size_t count, std::uint64_t* digests)
+        {
+            constexpr std::size_t lanes = Ops::_lanes;
+
+            std::size_t done{0};
+            for(; done+lanes <= count; done += lanes)
+            {
+                const std::string_view* group = keys + done;
+                std::uint64_t* state = digests + done;
+
+                std::uint64_t lens[lanes];
+                std::size_t maxLen{0};
+                for(std::size_t l{0}; l<lanes; ++l)
+                {
+                    state[l] = Fnv1a::_basis;
+                    lens[l] = group[l].size();
+                    maxLen = std::max(maxLen, group[l].size());
+                }
+
+                std::uint64_t words[lanes];
+                for(std::size_t pos{0}; pos < maxLen; pos += 8)
+                {
+                    for(std::size_t l{0}; l<lanes; ++l)
+                        words[l] = word(group[l], pos);
+
+                    Ops::step(state, words, lens, pos);
+                }
+            }
+
+            return done;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        DCI_UTILS_CPU_TARGET("avx2")
+        std::size_t batchAvx2(const std::string_view* keys, std::size_t count, std::uint64_t* digests)
+        {
+            return batchBlocks<Avx2>(keys, count, digests);
+        }
+
+        DCI_UTILS_CPU_TARGET("avx512f")
+        std::size_t batchAvx512(const std::string_view* keys, std::size_t count, std::uint64_t* digests)
+        {
+            return batchBlocks<Avx512>(keys, count, digests);
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // все ядра, пригодные на этом процессоре, от широкого к пустому (все ключи - скалярному хвосту); первое - рабочее
+        const std::vector<Kernel>& variants()
+        {
+            static const std::vector<Kernel> res = []
+            {
+                std::vector<Kernel> res;
+#if DCI_UTILS_CPU_X86
+                const cpu::Features& f = cpu::features();
+                if(f._avx512f)  res.push_back(batchAvx512);
+                if(f._avx2)     res.push_back(batchAvx2);
+#endif
+                res.push_back(batchNone);
+                return res;
+            }();
+
+            return res;
+        }
+
+        Kernel kernel()
+        {
+            static const Kernel res = variants().front();
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        void fnv1aBatchImpl(Kernel kernel, std::span<const std::string_view> keys, std::uint64_t* digests)
+        {
+            std::size_t done = kernel(keys.data(), keys.size(), digests);
+
+            for(; done < keys.size(); ++done)
+                digests[done] = fnv1a(keys[done]);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void fnv1aBatch(std::span<const std::string_view> keys, std::uint64_t* digests)
+    {
+        fnv1aBatchImpl(kernel(), keys, digests);
+    }
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t fnv1aBatchVariants()
+    {
+        return variants().size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void fnv1aBatchVariant(std::size_t variant, std::span<const std::string_view> keys, std::uint64_t* digests)
+    {
+        fnv1aBatchImpl(variants().at(variant), keys, digests);
+    }
+}
@@ -6,123 +6,469 @@
    You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
 
 #include <dci/utils/h2b.hpp>
+#include <dci/utils/hexFixed.hpp>
+#include "cpu.hpp"
+#include "workers.hpp"
 #include <cstdint>
+#include <bit>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace dci::utils
 {
     namespace
     {
-        bool dgt(char h, uint8_t& b)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        constexpr std::uint8_t bad = 0xff;
+
+        constexpr std::array<std::uint8_t, 256> values = []
         {
-            if(h >= '0' && h <= '9')
-            {
-                b = static_cast<uint8_t>(h-'0');
-                return true;
-            }
+            std::array<std::uint8_t, 256> res{};
+            res.fill(bad);
 
-            if(h >= 'a' && h <= 'f')
+            for(std::uint8_t i{0}; i<10; ++i)
+                res['0'+i] = i;
+
+            for(std::uint8_t i{0}; i<6; ++i)
             {
-                b = static_cast<uint8_t>(h-'a'+10);
-                return true;
+                res['a'+i] = static_cast<std::uint8_t>(10+i);
+                res['A'+i] = static_cast<std::uint8_t>(10+i);
             }
 
-            if(h >= 'A' && h <= 'F')
+            return res;
+        }();
+
+        std::uint8_t dgt(char h)
+        {
+            return values[static_cast<std::uint8_t>(h)];
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        std::size_t firstBad(const char* h, std::size_t hsize)
+        {
+            for(std::size_t i{0}; i<hsize; ++i)
+                if(bad == dgt(h[i]))
+                    return i;
+
+            return hsize;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // результат всех h2b_* - позиция первого недопустимого символа, либо hsize если весь вход корректен
+        template <HexEndian he>
+        std::size_t h2b_scalar(const char* h, std::size_t hsize, std::uint8_t* b)
+        {
+            if constexpr(HexEndian::big == he)
             {
-                b = static_cast<uint8_t>(h-'A'+10);
-                return true;
+                std::size_t hsizeOrig = hsize;
+                if(hsize & 1)
+                {
+                    std::uint8_t lo = dgt(h[hsize-1]);
+                    if(bad == lo) return firstBad(h, hsizeOrig);
+
+                    *b = lo;
+                    ++b;
+                    hsize -= 1;
+                }
+
+                for(std::size_t i{0}; i<hsize; i+=2, ++b)
+                {
+                    std::uint8_t lo = dgt(h[hsize-1-(i+0)]);
+                    std::uint8_t hi = dgt(h[hsize-1-(i+1)]);
+                    if(bad == lo || bad == hi) return firstBad(h, hsizeOrig);
+
+                    *b = static_cast<std::uint8_t>((hi<<4) | lo);
+                }
+
+                return hsizeOrig;
             }
+            else
+            {
+                std::size_t i{0};
+                for(; i<hsize/2*2; i+=2, ++b)
+                {
+                    std::uint8_t first = dgt(h[i+0]);
+                    if(bad == first) return i+0;
+                    std::uint8_t second = dgt(h[i+1]);
+                    if(bad == second) return i+1;
 
-            return false;
+                    if constexpr(HexEndian::little == he)
+                        *b = static_cast<std::uint8_t>((second<<4) | first);
+                    else
+                        *b = static_cast<std::uint8_t>((first<<4) | second);
+                }
+
+                if(hsize & 1)
+                {
+                    std::uint8_t last = dgt(h[i+0]);
+                    if(bad == last) return i+0;
+
+                    if constexpr(HexEndian::little == he)
+                        *b = last;
+                    else
+                        *b = static_cast<std::uint8_t>(last<<4);
+                }
+
+                return hsize;
+            }
         }
 
-        bool h2b_little(const char* h, std::size_t hsize, std::uint8_t* b)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // блочный проход: kernel декодирует blockSize символов в blockSize/2 байт и возвращает битовую маску недопустимых символов.
+        // Для big блоки берутся с конца входа, нечетный последний символ дает младший байт
+        template <HexEndian he, std::size_t blockSize, class Kernel>
+        DCI_UTILS_CPU_INLINE std::size_t h2b_blocks(const char* h, std::size_t hsize, std::uint8_t* b, Kernel&& kernel)
         {
-            std::size_t i{0};
-            for(; i<hsize/2*2; i+=2, ++b)
+            if constexpr(HexEndian::big == he)
             {
-                uint8_t hi, lo;
-                if(!dgt(h[i+0], lo)) return false;
-                if(!dgt(h[i+1], hi)) return false;
+                std::size_t hsizeOrig = hsize;
+                if(hsize & 1)
+                {
+                    std::uint8_t lo = dgt(h[hsize-1]);
+                    if(bad == lo) return firstBad(h, hsizeOrig);
 
-                *b = static_cast<uint8_t>((hi<<4) | lo);
-            }
+                    *b = lo;
+                    ++b;
+                    hsize -= 1;
+                }
+
+                std::size_t done{0};
+                for(; done+blockSize <= hsize; done += blockSize)
+                {
+                    if(kernel(h + hsize - done - blockSize, b + done/2))
+                        return firstBad(h, hsize - done);
+                }
 
-            if(hsize & 1)
+                std::size_t rest = hsize - done;
+                std::size_t res = h2b_scalar<he>(h, rest, b + done/2);
+                return res == rest ? hsizeOrig : res;
+            }
+            else
             {
-                uint8_t lo;
-                if(!dgt(h[i+0], lo)) return false;
+                std::size_t done{0};
+                for(; done+blockSize <= hsize; done += blockSize)
+                {
+                    if(auto mask = kernel(h + done, b + done/2))
+                        return done + static_cast<std::size_t>(std::countr_zero(mask));
+                }
 
-                *b = lo;
+                std::size_t rest = hsize - done;
+                std::size_t res = h2b_scalar<he>(h + done, rest, b + done/2);
+                return res == rest ? hsize : done + res;
             }
+        }
+
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("sse2")
+        std::size_t h2b_sse2(const char* h, std::size_t hsize, std::uint8_t* b)
+        {
+            return h2b_blocks<he, 16>(h, hsize, b, [](const char* h, std::uint8_t* b) DCI_UTILS_CPU_TARGET("sse2")
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h));
+
+                // '0'..'9' и 'a'..'f'/'A'..'F' проверяются беззнаковым сравнением через min
+                __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+                __m128i dOk = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+                __m128i l = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+                __m128i lOk = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+
+                std::uint32_t mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(dOk, lOk))) & 0xffff;
 
-            return true;
+                __m128i n = _mm_or_si128(_mm_and_si128(dOk, d), _mm_and_si128(lOk, _mm_add_epi8(l, _mm_set1_epi8(10))));
+                __m128i first = _mm_and_si128(n, _mm_set1_epi16(0x00ff));
+                __m128i second = _mm_srli_epi16(n, 8);
+
+                __m128i w = HexEndian::little == he ?
+                                _mm_or_si128(first, _mm_slli_epi16(second, 4)) :
+                                _mm_or_si128(_mm_slli_epi16(first, 4), second);
+                __m128i r = _mm_packus_epi16(w, w);
+
+                if constexpr(HexEndian::big == he)
+                {
+                    r = _mm_shufflelo_epi16(r, 0x1b);
+                    r = _mm_or_si128(_mm_slli_epi16(r, 8), _mm_srli_epi16(r, 8));
+                }
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(b), r);
+                return mask;
+            });
         }
 
-        bool h2b_middle(const char* h, std::size_t hsize, std::uint8_t* b)
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <HexEndian he>
+        DCI_UTILS_CPU_TARGET("avx2")
+        std::size_t h2b_avx2(const char* h, std::size_t hsize, std::uint8_t* b)
         {
-            std::size_t i{0};
-            for(; i<hsize/2*2; i+=2, ++b)
+            return h2b_blocks<he, 32>(h, hsize, b, [](const char* h, std::uint8_t* b) DCI_UTILS_CPU_TARGET("avx2")
             {
-                uint8_t hi, lo;
-                if(!dgt(h[i+0], hi)) return false;
-                if(!dgt(h[i+1], lo)) return false;
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h));
 
-                *b = static_cast<uint8_t>((hi<<4) | lo);
-            }
+                __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+                __m256i dOk = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+                __m256i l = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+                __m256i lOk = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+
+                std::uint32_t mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(dOk, lOk)));
+
+                __m256i n = _mm256_or_si256(_mm256_and_si256(dOk, d), _mm256_and_si256(lOk, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+                __m256i first = _mm256_and_si256(n, _mm256_set1_epi16(0x00ff));
+                __m256i second = _mm256_srli_epi16(n, 8);
+
+                __m256i w = HexEndian::little == he ?
+                                _mm256_or_si256(first, _mm256_slli_epi16(second, 4)) :
+                                _mm256_or_si256(_mm256_slli_epi16(first, 4), second);
 
-            if(hsize & 1)
+                // pack работает внутри 128-битных половин, собираем младшие qword каждой половины
+                __m128i r = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(w, w), 0x08));
+
+                if constexpr(HexEndian::big == he)
+                    r = _mm_shuffle_epi8(r, _mm_setr_epi8(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(b), r);
+                return mask;
+            });
+        }
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        using Kernel = std::size_t (*)(const char* h, std::size_t hsize, std::uint8_t* b);
+
+        struct Kernels
+        {
+            Kernel _little;
+            Kernel _middle;
+            Kernel _big;
+        };
+
+        // все наборы, пригодные на этом процессоре, от лучшего к эталонному; первый - рабочий
+        const std::vector<Kernels>& variants()
+        {
+            static const std::vector<Kernels> res = []
             {
-                uint8_t hi;
-                if(!dgt(h[i+0], hi)) return false;
+                std::vector<Kernels> res;
+#if DCI_UTILS_CPU_X86
+                const cpu::Features& f = cpu::features();
+                if(f._avx2) res.push_back({h2b_avx2<HexEndian::little>, h2b_avx2<HexEndian::middle>, h2b_avx2<HexEndian::big>});
+                if(f._sse2) res.push_back({h2b_sse2<HexEndian::little>, h2b_sse2<HexEndian::middle>, h2b_sse2<HexEndian::big>});
+#endif
+                res.push_back({h2b_scalar<HexEndian::little>, h2b_scalar<HexEndian::middle>, h2b_scalar<HexEndian::big>});
+                return res;
+            }();
+
+            return res;
+        }
+
+        const Kernels& kernels()
+        {
+            static const Kernels& res = variants().front();
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        std::size_t h2bImpl(const Kernels& ks, const void* h, std::size_t hsize, void* b, HexEndian he)
+        {
+            const char* h_ = static_cast<const char *>(h);
+            std::uint8_t* b_ = static_cast<std::uint8_t *>(b);
 
-                *b = static_cast<uint8_t>(hi<<4);
+            switch(he)
+            {
+            case HexEndian::little:
+                return ks._little(h_, hsize, b_);
+            case HexEndian::middle:
+                return ks._middle(h_, hsize, b_);
+            case HexEndian::big:
+                return ks._big(h_, hsize, b_);
             }
 
-            return true;
+            return 0;
         }
 
-        bool h2b_big(const char* h, std::size_t hsize, std::uint8_t* b)
+        std::size_t h2bImpl(const void* h, std::size_t hsize, void* b, HexEndian he)
         {
-            if(hsize & 1)
+            return h2bImpl(kernels(), h, hsize, b, he);
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // цифры без разделителей и префиксов собираются в блок на стеке, полный блок отдается в sink(digits, size, offset).
+        // Блок четного размера, поэтому пары символов не разрываются
+        template <class Sink>
+        bool separatedScan(const char* h, std::size_t hsize, const std::array<bool, 256>& separators, bool allowPrefix, Sink&& sink)
+        {
+            char block[256];
+            std::size_t size{0};
+            std::size_t offset{0};
+            bool tokenStart{true};
+
+            auto flush = [&]
             {
-                uint8_t lo;
-                if(!dgt(h[hsize-1], lo)) return false;
+                if(!size)
+                    return true;
 
-                *b = lo;
-                ++b;
-                hsize -= 1;
-            }
+                bool res = sink(block, size, offset);
+                offset += size;
+                size = 0;
+                return res;
+            };
 
-            std::size_t i{0};
-            for(; i<hsize; i+=2, ++b)
+            for(std::size_t i{0}; i<hsize;)
             {
-                uint8_t hi, lo;
-                if(!dgt(h[hsize-1-(i+0)], lo)) return false;
-                if(!dgt(h[hsize-1-(i+1)], hi)) return false;
+                // быстрый путь для 8 цифр подряд, префикс "0x" сюда не попадает - 'x' не цифра
+                std::uint32_t unused;
+                std::uint64_t word;
+                if(i+8 <= hsize && size+8 <= sizeof(block) && (std::memcpy(&word, h+i, 8), details::h2bFixed4(word, false, unused)))
+                {
+                    std::memcpy(block+size, h+i, 8);
+                    size += 8;
+                    i += 8;
+                    tokenStart = false;
+                }
+                else
+                {
+                    char c = h[i];
+                    if(bad != values[static_cast<std::uint8_t>(c)])
+                    {
+                        if(allowPrefix && tokenStart && '0' == c && i+1 < hsize && 'x' == (h[i+1] | 0x20))
+                        {
+                            i += 2;
+                            tokenStart = false;
+                            continue;
+                        }
 
-                *b = static_cast<uint8_t>((hi<<4) | lo);
+                        block[size++] = c;
+                        tokenStart = false;
+                    }
+                    else if(separators[static_cast<std::uint8_t>(c)])
+                    {
+                        tokenStart = true;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+
+                    ++i;
+                }
+
+                if(sizeof(block) == size && !flush())
+                    return false;
             }
 
-            return true;
+            return flush();
         }
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     bool h2b(const void* h, std::size_t hsize, void* b, HexEndian he)
+    {
+        return hsize == h2bImpl(h, hsize, b, he);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool h2b(const void* h, std::size_t hsize, void* b, std::size_t& badOffset, HexEndian he)
+    {
+        badOffset = h2bImpl(h, hsize, b, he);
+        return hsize == badOffset;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool h2bParallel(const void* h, std::size_t hsize, void* b, HexEndian he, std::size_t serialThreshold)
+    {
+        if(hsize <= serialThreshold)
+            return h2b(h, hsize, b, he);
+
+        constexpr std::size_t chunkSize = 256*1024;
+
+        const char* h_ = static_cast<const char *>(h);
+        std::uint8_t* b_ = static_cast<std::uint8_t *>(b);
+
+        // для big нечетный последний символ дает первый байт, остальное - четное количество символов
+        if(HexEndian::big == he && (hsize & 1))
+        {
+            if(!h2b(h_ + hsize - 1, 1, b_, he))
+                return false;
+
+            ++b_;
+            --hsize;
+        }
+
+        std::atomic<bool> res{true};
+        workers::parallelFor((hsize + chunkSize - 1) / chunkSize, [&](std::size_t index)
+        {
+            if(!res.load(std::memory_order_relaxed))
+                return;
+
+            std::size_t begin = index * chunkSize;
+            std::size_t size = std::min(chunkSize, hsize - begin);
+
+            // chunkSize четный, поэтому куски не разрывают пары символов; нечетный хвост little/middle попадает в последний кусок
+            std::size_t bpos = HexEndian::big == he ? (hsize - begin - size)/2 : begin/2;
+            if(!h2b(h_ + begin, size, b_ + bpos, he))
+                res.store(false, std::memory_order_relaxed);
+        });
+
+        return res.load();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool h2bSeparated(const void* h, std::size_t hsize, void* b, std::size_t& bsize, HexEndian he, std::string_view separators, bool allowPrefix)
     {
         const char* h_ = static_cast<const char *>(h);
         std::uint8_t* b_ = static_cast<std::uint8_t *>(b);
 
-        switch(he)
+        std::array<bool, 256> separators_{};
+        for(char c : separators)
+            separators_[static_cast<std::uint8_t>(c)] = true;
+
+        if(HexEndian::big == he)
+        {
+            // результат заполняется с конца, нужно заранее знать количество цифр
+            std::size_t digits{0};
+            if(!separatedScan(h_, hsize, separators_, allowPrefix, [&](const char*, std::size_t size, std::size_t)
+            {
+                digits += size;
+                return true;
+            }))
+            {
+                return false;
+            }
+
+            bsize = (digits+1)/2;
+            return separatedScan(h_, hsize, separators_, allowPrefix, [&](const char* block, std::size_t size, std::size_t offset)
+            {
+                return size == h2bImpl(block, size, b_ + bsize - offset/2 - (size+1)/2, he);
+            });
+        }
+
+        std::size_t digits{0};
+        if(!separatedScan(h_, hsize, separators_, allowPrefix, [&](const char* block, std::size_t size, std::size_t offset)
         {
-        case HexEndian::little:
-            return h2b_little(h_, hsize, b_);
-        case HexEndian::middle:
-            return h2b_middle(h_, hsize, b_);
-        case HexEndian::big:
-            return h2b_big(h_, hsize, b_);
+            digits = offset + size;
+            return size == h2bImpl(block, size, b_ + offset/2, he);
+        }))
+        {
+            return false;
         }
 
-        return false;
+        bsize = (digits+1)/2;
+        return true;
+    }
+}
+
+namespace dci::utils::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t h2bVariants()
+    {
+        return variants().size();
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool h2bVariant(std::size_t variant, const void* h, std::size_t hsize, void* b, std::size_t& badOffset, HexEndian he)
+    {
+        badOffset = h2bImpl(variants().at(variant), h, hsize, b, he);
+        return hsize == badOffset;
     }
 }
@@ -0,0 +1,172 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/hexStream.hpp>
+#include <dci/utils/b2h.hpp>
+#include <dci/utils/h2b.hpp>
+#include <stdexcept>
+
+namespace dci::utils
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    HexEncoder::HexEncoder(HexEndian he)
+        : _he{he}
+    {
+        if(HexEndian::big == _he)
+            throw std::invalid_argument("HexEncoder: HexEndian::big is not streamable");
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t HexEncoder::outputSize(std::size_t bsize)
+    {
+        return bsize*2;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t HexEncoder::update(const void* b, std::size_t bsize, void* h)
+    {
+        b2h(b, bsize, h, _he);
+        _consumed += bsize;
+        return bsize*2;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::uint64_t HexEncoder::consumed() const
+    {
+        return _consumed;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void HexEncoder::reset()
+    {
+        _consumed = 0;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    HexDecoder::HexDecoder(HexEndian he)
+        : _he{he}
+    {
+        if(HexEndian::big == _he)
+            throw std::invalid_argument("HexDecoder: HexEndian::big is not streamable");
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t HexDecoder::outputSize(std::size_t hsize) const
+    {
+        return (hsize + (_pending ? 1 : 0)) / 2;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool HexDecoder::update(const void* h, std::size_t hsize, void* b, std::size_t& bsize)
+    {
+        bsize = 0;
+        if(_failed)
+            return false;
+
+        const char* h_ = static_cast<const char *>(h);
+        std::uint8_t* b_ = static_cast<std::uint8_t *>(b);
+
+        if(_pending && hsize)
+        {
+            // перенесенный символ уже проверен, ошибка может быть только во втором
+            const char pair[2] = {_pendingChar, h_[0]};
+            if(!h2b(pair, 2, b_, _he))
+            {
+                _failed = true;
+                _badOffset = _consumed;
+                return false;
+            }
+
+            _pending = false;
+            ++h_;
+            --hsize;
+            ++_consumed;
+            ++b_;
+            ++bsize;
+        }
+
+        std::size_t even = hsize & ~std::size_t{1};
+        std::size_t badOffset;
+        if(!h2b(h_, even, b_, badOffset, _he))
+        {
+            _failed = true;
+            _badOffset = _consumed + badOffset;
+            return false;
+        }
+
+        bsize += even/2;
+        _consumed += even;
+
+        if(hsize & 1)
+        {
+            std::uint8_t probe;
+            if(!h2b(h_ + even, 1, &probe, _he))
+            {
+                _failed = true;
+                _badOffset = _consumed;
+                return false;
+            }
+
+            _pending = true;
+            _pendingChar = h_[even];
+            ++_consumed;
+        }
+
+        return true;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool HexDecoder::finish(void* b, std::size_t& bsize)
+    {
+        bsize = 0;
+        if(_failed)
+            return false;
+
+        if(_pending)
+        {
+            h2b(&_pendingChar, 1, b, _he);
+            _pending = false;
+            bsize = 1;
+        }
+
+        return true;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool HexDecoder::pending() const
+    {
+        return _pending;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool HexDecoder::failed() const
+    {
+        return _failed;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::uint64_t HexDecoder::badOffset() const
+    {
+        return _badOffset;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::uint64_t HexDecoder::consumed() const
+    {
+        return _consumed;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void HexDecoder::reset()
+    {
+        _consumed = 0;
+        _badOffset = 0;
+        _failed = false;
+        _pending = false;
+        _pendingChar = 0;
+    }
+}
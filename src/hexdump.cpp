@@ -0,0 +1,295 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/utils/hexdump.hpp>
+#include "cpu.hpp"
+#include <array>
+#include <cstring>
+#include <algorithm>
+#include <ostream>
+
+namespace dci::utils
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        constexpr const char* digits = "0123456789abcdef";
+
+        constexpr std::array<std::array<char, 2>, 256> pairs = []
+        {
+            std::array<std::array<char, 2>, 256> res{};
+            for(std::size_t i{0}; i<256; ++i)
+                res[i] = {digits[i >> 4], digits[i & 0x0f]};
+            return res;
+        }();
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // геометрия строки, вычисляется один раз на весь вывод
+        struct Layout
+        {
+            std::size_t     _width;
+            std::size_t     _group;
+            bool            _ascii;
+            std::size_t     _offsetDigits;
+            std::uint64_t   _baseOffset;
+            std::size_t     _hexArea;       // колонка байт вместе с пробелами групп
+
+            Layout(std::size_t bsize, const HexdumpFormat& format)
+                : _width{format._width ? format._width : HexdumpFormat{}._width}
+                , _group{format._group ? std::min(format._group, _width) : _width}
+                , _ascii{format._ascii}
+                , _offsetDigits{std::max<std::size_t>(format._offsetDigits, 1)}
+                , _baseOffset{format._baseOffset}
+            {
+                std::uint64_t maxOffset = _baseOffset + bsize;
+                std::size_t need{1};
+                while(maxOffset >>= 4)
+                    ++need;
+                _offsetDigits = std::max(_offsetDigits, need);
+
+                _hexArea = _width*3 + (_width + _group - 1) / _group;
+            }
+
+            std::size_t lineSize(std::size_t bytes) const
+            {
+                if(_ascii)
+                    return _offsetDigits + 2 + _hexArea + 1 + bytes + 1 + 1;
+
+                // без колонки символов хвостовые пробелы не пишутся
+                return _offsetDigits + 2 + bytes*3 - 1 + (bytes + _group - 1) / _group - 1 + 1;
+            }
+
+            std::size_t size(std::size_t bsize) const
+            {
+                if(!bsize)
+                    return 0;
+
+                std::size_t rest = bsize % _width;
+                return bsize / _width * lineSize(_width) + (rest ? lineSize(rest) : 0) + _offsetDigits + 1;
+            }
+        };
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        char* writeOffset(char* out, std::uint64_t offset, std::size_t count)
+        {
+            for(std::size_t i{count}; i; --i)
+            {
+                out[i-1] = digits[offset & 0x0f];
+                offset >>= 4;
+            }
+
+            return out + count;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        struct Scalar
+        {
+            static constexpr bool _wide = false;
+
+            static void hex8(const std::uint8_t*, char*) {}
+            static void ascii16(const std::uint8_t*, char*) {}
+        };
+
+        char ascii(std::uint8_t c)
+        {
+            return c >= 0x20 && c < 0x7f ? static_cast<char>(c) : '.';
+        }
+
+#if DCI_UTILS_CPU_X86
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        struct Ssse3
+        {
+            static constexpr bool _wide = true;
+
+            // 8 байт -> "xx xx xx xx xx xx xx xx " (24 символа)
+            DCI_UTILS_CPU_TARGET("ssse3")
+            static void hex8(const std::uint8_t* b, char* out)
+            {
+                const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+                const __m128i mask = _mm_set1_epi8(0x0f);
+
+                __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b));
+                __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+                __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+                __m128i chars = _mm_unpacklo_epi8(hi, lo);
+
+                __m128i r0 = _mm_or_si128(_mm_shuffle_epi8(chars, _mm_setr_epi8(0,1,-1, 2,3,-1, 4,5,-1, 6,7,-1, 8,9,-1, 10)),
+                                          _mm_setr_epi8(0,0,' ', 0,0,' ', 0,0,' ', 0,0,' ', 0,0,' ', 0));
+                __m128i r1 = _mm_or_si128(_mm_shuffle_epi8(chars, _mm_setr_epi8(11,-1, 12,13,-1, 14,15,-1, -1,-1,-1,-1,-1,-1,-1,-1)),
+                                          _mm_setr_epi8(0,' ', 0,0,' ', 0,0,' ', 0,0,0,0,0,0,0,0));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), r0);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out+16), r1);
+            }
+
+            // 16 байт -> печатные символы, прочие '.'
+            DCI_UTILS_CPU_TARGET("ssse3")
+            static void ascii16(const std::uint8_t* b, char* out)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+                __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1f)), _mm_cmplt_epi8(v, _mm_set1_epi8(0x7f)));
+                __m128i r = _mm_or_si128(_mm_and_si128(printable, v), _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), r);
+            }
+        };
+#endif
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <class Ops>
+        DCI_UTILS_CPU_INLINE char* writeLine(const std::uint8_t* b, std::size_t bytes, std::uint64_t offset, char* out, const Layout& layout)
+        {
+            out = writeOffset(out, offset, layout._offsetDigits);
+            *out++ = ' ';
+            *out++ = ' ';
+
+            char* hexBegin = out;
+            for(std::size_t groupBegin{0}; groupBegin < bytes; groupBegin += layout._group)
+            {
+                std::size_t groupSize = std::min(layout._group, bytes - groupBegin);
+                const std::uint8_t* g = b + groupBegin;
+
+                std::size_t i{0};
+                if constexpr(Ops::_wide)
+                {
+                    for(; i+8 <= groupSize; i += 8, out += 24)
+                        Ops::hex8(g+i, out);
+                }
+
+                for(; i<groupSize; ++i, out += 3)
+                {
+                    std::memcpy(out, pairs[g[i]].data(), 2);
+                    out[2] = ' ';
+                }
+
+                if(layout._ascii || groupBegin + groupSize < bytes)
+                    *out++ = ' ';
+            }
+
+            if(!layout._ascii)
+            {
+                // пробел после последнего байта заменяется переводом строки
+                out[-1] = '\n';
+                return out;
+            }
+
+            char* hexEnd = hexBegin + layout._hexArea;
+            std::memset(out, ' ', static_cast<std::size_t>(hexEnd - out));
+            out = hexEnd;
+
+            *out++ = '|';
+            std::size_t i{0};
+            if constexpr(Ops::_wide)
+            {
+                for(; i+16 <= bytes; i += 16)
+                    Ops::ascii16(b+i, out+i);
+            }
+            for(; i<bytes; ++i)
+                out[i] = ascii(b[i]);
+            out += bytes;
+            *out++ = '|';
+            *out++ = '\n';
+
+            return out;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <class Ops>
+        DCI_UTILS_CPU_INLINE char* writeLines(const std::uint8_t* b, std::size_t bsize, std::uint64_t offset, char* out, const Layout& layout)
+        {
+            for(std::size_t pos{0}; pos < bsize; pos += layout._width)
+                out = writeLine<Ops>(b + pos, std::min(layout._width, bsize - pos), offset + pos, out, layout);
+
+            return out;
+        }
+
+        using Kernel = char* (*)(const std::uint8_t* b, std::size_t bsize, std::uint64_t offset, char* out, const Layout& layout);
+
+        char* writeLinesScalar(const std::uint8_t* b, std::size_t bsize, std::uint64_t offset, char* out, const Layout& layout)
+        {
+            return writeLines<Scalar>(b, bsize, offset, out, layout);
+        }
+
+#if DCI_UTILS_CPU_X86
+        DCI_UTILS_CPU_TARGET("ssse3")
+        char* writeLinesSsse3(const std::uint8_t* b, std::size_t bsize, std::uint64_t offset, char* out, const Layout& layout)
+        {
+            return writeLines<Ssse3>(b, bsize, offset, out, layout);
+        }
+#endif
+
+        Kernel kernel()
+        {
+            static const Kernel res = []() -> Kernel
+            {
+#if DCI_UTILS_CPU_X86
+                if(cpu::features()._ssse3) return writeLinesSsse3;
+#endif
+                return writeLinesScalar;
+            }();
+
+            return res;
+        }
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        char* writeFinal(std::size_t bsize, char* out, const Layout& layout)
+        {
+            if(!bsize)
+                return out;
+
+            out = writeOffset(out, layout._baseOffset + bsize, layout._offsetDigits);
+            *out++ = '\n';
+            return out;
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t hexdumpSize(std::size_t bsize, const HexdumpFormat& format)
+    {
+        return Layout{bsize, format}.size(bsize);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void hexdump(const void* b, std::size_t bsize, char* out, const HexdumpFormat& format)
+    {
+        Layout layout{bsize, format};
+        out = kernel()(static_cast<const std::uint8_t *>(b), bsize, layout._baseOffset, out, layout);
+        writeFinal(bsize, out, layout);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string hexdump(const void* b, std::size_t bsize, const HexdumpFormat& format)
+    {
+        std::string res;
+        res.resize(hexdumpSize(bsize, format));
+        hexdump(b, bsize, res.data(), format);
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void hexdump(const void* b, std::size_t bsize, std::ostream& out, const HexdumpFormat& format)
+    {
+        Layout layout{bsize, format};
+        const std::uint8_t* b_ = static_cast<const std::uint8_t *>(b);
+
+        // порция - целое число строк, примерно 64K вывода
+        std::size_t chunkLines = std::max<std::size_t>(1, 64*1024 / layout.lineSize(layout._width));
+        std::size_t chunkBytes = chunkLines * layout._width;
+
+        std::string buf;
+        buf.resize(layout.size(std::min(chunkBytes, bsize)));
+
+        for(std::size_t pos{0}; pos < bsize; pos += chunkBytes)
+        {
+            std::size_t size = std::min(chunkBytes, bsize - pos);
+            char* end = kernel()(b_ + pos, size, layout._baseOffset + pos, buf.data(), layout);
+            out.write(buf.data(), end - buf.data());
+        }
+
+        char* end = writeFinal(bsize, buf.data(), layout);
+        out.write(buf.data(), end - buf.data());
+    }
+}
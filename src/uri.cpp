@@ -7,138 +7,176 @@
 
 #include <dci/utils/uri.hpp>
 #include <dci/utils/ip.hpp>
+#include <dci/utils/perfectHash.hpp>
+#include <dci/utils/compactUri.hpp>
+#include <dci/utils/flatHash.hpp>
+#include "charScan.hpp"
+#include "workers.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
-namespace boost::spirit::x3::traits
+using namespace std::string_view_literals;
+using namespace dci::utils;
+using namespace dci::utils::uri;
+
+namespace
 {
-    template <typename It>
-    void move_to(It b, It e, std::string_view& dest)
-    {
-        dest = std::string_view(b, e);
-    }
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Разбор за один проход по исходной строке. Откат есть только внутри IPv6-литерала:
+    // ip6 по очереди пробует ограниченный набор альтернатив ip6Alts. Правила ниже повторяют
+    // грамматику RFC 3986 с теми же отступлениями, что были в прежней реализации на
+    // boost::spirit::x3 (включая порядок альтернатив), каждое правило возвращает конец
+    // совпадения или nullptr.
 
-    template <typename It>
-    void move_to(It b, It e, std::optional<std::string_view>& dest)
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    enum CharClass : std::uint16_t
     {
-        dest = std::string_view(b, e);
-    }
+        ccAlpha         = 0x001,
+        ccDigit         = 0x002,
+        ccHexDig        = 0x004,
+        ccUnreserved    = 0x008, // unreserved  = ALPHA / DIGIT / "-" / "." / "_" / "~"
+        ccSubDelims     = 0x010, // sub-delims  = "!" / "$" / "&" / "'" / "(" / ")" / "*" / "+" / "," / ";" / "="
+        ccScheme        = 0x020, // ALPHA / DIGIT / "+" / "-" / "."
+        ccColon         = 0x040,
+        ccAt            = 0x080,
+        ccSlash         = 0x100,
+    };
 
-    template <typename It>
-    void move_to(It b, It e, std::string& dest)
+    constexpr std::array<std::uint16_t, 256> charClasses = []
     {
-        dest = std::string(b, e);
-    }
+        std::array<std::uint16_t, 256> res{};
 
-    template <typename It>
-    void move_to(It b, It e, std::optional<std::string>& dest)
-    {
-        dest = std::string(b, e);
-    }
+        auto add = [&](std::string_view chars, std::uint16_t cc)
+        {
+            for(char c : chars)
+                res[static_cast<unsigned char>(c)] |= cc;
+        };
+
+        add("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ", ccAlpha | ccUnreserved | ccScheme);
+        add("0123456789", ccDigit | ccHexDig | ccUnreserved | ccScheme);
+        add("abcdefABCDEF", ccHexDig);
+        add("-._~", ccUnreserved);
+        add("+-.", ccScheme);
+        add("!$&'()*+,;=", ccSubDelims);
+        add(":", ccColon);
+        add("@", ccAt);
+        add("/", ccSlash);
 
-    template <typename It, class String>
-    void move_to(It b, It e, dci::utils::uri::networkNode::RegName<String>& dest)
-    {
-        move_to(b, e, static_cast<String&>(dest));
-    }
+        return res;
+    }();
 
-    template <typename It, class String>
-    void move_to(It b, It e, dci::utils::uri::networkNode::Ip4<String>& dest)
+    constexpr std::uint16_t ccRegName = ccUnreserved | ccSubDelims;
+    constexpr std::uint16_t ccPchar = ccUnreserved | ccSubDelims | ccColon | ccAt;
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // те же классы для векторного поиска: длинные пути и query пробегаются по 16/32 байта
+    constexpr charScan::Set charSet(std::uint16_t cc)
     {
-        move_to(b, e, static_cast<String&>(dest));
+        charScan::Set res;
+        for(std::size_t c{}; c < 0x80; ++c)
+            if(charClasses[c] & cc)
+                res.add(static_cast<char>(c));
+        return res;
     }
 
-    template <typename It, class String>
-    void move_to(It b, It e, dci::utils::uri::networkNode::Ip6<String>& dest)
+    constexpr charScan::Set regNameSet = charSet(ccRegName);
+    constexpr charScan::Set userpasswdSet = charSet(ccRegName | ccColon);
+    constexpr charScan::Set pcharSet = charSet(ccPchar);
+    constexpr charScan::Set pathSet = charSet(ccPchar | ccSlash);
+    constexpr charScan::Set hierPartEndSet{"?#"};
+    constexpr charScan::Set queryEndSet{"#"};
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool is(char c, std::uint16_t cc)
     {
-        move_to(b, e, static_cast<String&>(dest));
+        return charClasses[static_cast<unsigned char>(c)] & cc;
     }
 
-    template <typename It, class String>
-    void move_to(It b, It e, dci::utils::uri::networkNode::IpFuture<String>& dest)
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // *cc
+    const char* scan(const char* p, const char* e, std::uint16_t cc)
     {
-        move_to(b, e, static_cast<String&>(dest));
+        while(p != e && is(*p, cc))
+            ++p;
+        return p;
     }
-}
-
-#include <boost/spirit/home/x3.hpp>
-#include <boost/fusion/adapted/struct/adapt_struct.hpp>
-#include <boost/fusion/adapted/std_tuple.hpp>
-#include <boost/fusion/include/std_tuple.hpp>
 
-namespace boost::spirit::x3
-{
-    template <class Var, class Alternative>
-    struct transform_attribute<Var, Alternative, std::void_t<decltype(Var{} = Alternative{})>>
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // *( set / pct-encoded ), pct-encoded = "%" HEXDIG HEXDIG
+    const char* scanPct(const char* p, const char* e, const charScan::Set& set)
     {
-        typedef Alternative type;
-        static Alternative pre(Var&)
-        {
-            return Alternative{};
-        }
-        static void post(Var& var, Alternative&& alt)
+        for(;;)
         {
-            var = std::forward<Alternative>(alt);
+            p = charScan::skip(p, e, set);
+            if(e - p >= 3 && '%' == p[0] && is(p[1], ccHexDig) && is(p[2], ccHexDig))
+                p += 3;
+            else
+                return p;
         }
-    };
-}
-
-BOOST_FUSION_ADAPT_TPL_STRUCT(
-    (String),
-    (dci::utils::uri::www::Userinfo) (String),
-    (String, _name),
-    (std::optional<String>, _password)
-);
-
-namespace x3 = boost::spirit::x3;
-using namespace std::string_view_literals;
-using namespace dci::utils;
-using namespace dci::utils::uri;
-
-namespace
-{
-    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    const auto alpha = x3::char_('a', 'z') | x3::char_('A', 'Z');
-    const auto digit = x3::char_('0', '9');
-    const auto hexDig = x3::char_('0', '9') | x3::char_('a', 'f') | x3::char_('A', 'F');
-
-    // unreserved  = ALPHA / DIGIT / "-" / "." / "_" / "~"
-    const auto unreserved = alpha | digit | x3::char_("-._~");
-    // pct-encoded = "%" HEXDIG HEXDIG
-    const auto pctEncoded = x3::char_('%') >> hexDig >> hexDig;
-    // sub-delims  = "!" / "$" / "&" / "'" / "(" / ")" / "*" / "+" / "," / ";" / "="
-    const auto subDelims  = x3::char_("!$&'()*+,;=");
-
-    // pchar         = unreserved / pct-encoded / sub-delims / ":" / "@"
-    const auto pchar = unreserved | pctEncoded | subDelims | ':' | '@';
+    }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    // userinfo    = *( unreserved / pct-encoded / sub-delims / ":" )
-    const auto username = *(unreserved | pctEncoded | subDelims);
-    const auto userpasswd = *(unreserved | pctEncoded | subDelims | ':');
+    // dec-octet   = "25" %x30-35 / "2" %x30-34 DIGIT / "1" 2DIGIT / %x31-39 DIGIT / DIGIT
+    const char* decOctet(const char* p, const char* e)
+    {
+        std::ptrdiff_t size = e - p;
+        if(size >= 3 && '2' == p[0] && '5' == p[1] && p[2] >= '0' && p[2] <= '5')                return p + 3;
+        if(size >= 3 && '2' == p[0] && p[1] >= '0' && p[1] <= '4' && is(p[2], ccDigit))         return p + 3;
+        if(size >= 3 && '1' == p[0] && is(p[1], ccDigit) && is(p[2], ccDigit))                  return p + 3;
+        if(size >= 2 && p[0] >= '1' && p[0] <= '9' && is(p[1], ccDigit))                        return p + 2;
+        if(size >= 1 && is(p[0], ccDigit))                                                       return p + 1;
+        return nullptr;
+    }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    // dec-octet   = DIGIT                 ; 0-9
-    //             / %x31-39 DIGIT         ; 10-99
-    //             / "1" 2DIGIT            ; 100-199
-    //             / "2" %x30-34 DIGIT     ; 200-249
-    //             / "25" %x30-35          ; 250-255
-    const auto decOctet =
-          ("25" >> x3::char_('0', '5'))
-        | ('2' >> x3::char_('0', '4') >> digit)
-        | ('1' >> digit >> digit)
-        | (x3::char_('1', '9') >> digit)
-        | digit;
-
     // IPv4address = dec-octet "." dec-octet "." dec-octet "." dec-octet
-    const auto ip4 = decOctet >> '.' >> decOctet >> '.' >> decOctet >> '.' >> decOctet;
+    const char* ip4(const char* p, const char* e)
+    {
+        p = decOctet(p, e);
+        for(int i{}; i < 3 && p; ++i)
+            p = (p != e && '.' == *p) ? decOctet(p + 1, e) : nullptr;
+        return p;
+    }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     // h16         = 1*4HEXDIG
-    //             ; 16 bits of address represented in hexadecimal
-    const auto h16 = x3::repeat(1, 4)[hexDig];
+    const char* h16(const char* p, const char* e)
+    {
+        const char* b = p;
+        while(p != e && p - b < 4 && is(*p, ccHexDig))
+            ++p;
+        return p != b ? p : nullptr;
+    }
+
+    // h16 ":"
+    const char* h16Colon(const char* p, const char* e)
+    {
+        p = h16(p, e);
+        return (p && p != e && ':' == *p) ? p + 1 : nullptr;
+    }
 
     // ls32        = ( h16 ":" h16 ) / IPv4address
-    //             ; least-significant 32 bits of address
-    const auto ls32 = ( h16 >> ':' >> h16 ) | ip4;
+    const char* ls32(const char* p, const char* e)
+    {
+        if(const char* q = h16Colon(p, e))
+            if(const char* r = h16(q, e))
+                return r;
+        return ip4(p, e);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // "%" *pchar - идентификатор зоны, отступление от спеки
+    const char* zone(const char* p, const char* e)
+    {
+        return (p != e && '%' == *p) ? scanPct(p + 1, e, pcharSet) : p;
+    }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     // IPv6address =                            6( h16 ":" ) ls32
     //             /                       "::" 5( h16 ":" ) ls32
     //             / [               h16 ] "::" 4( h16 ":" ) ls32
@@ -148,459 +186,846 @@ namespace
     //             / [ *4( h16 ":" ) h16 ] "::"              ls32
     //             / [ *5( h16 ":" ) h16 ] "::"              h16
     //             / [ *6( h16 ":" ) h16 ] "::"
-    const auto ip6 =
-        (
-              (                                               x3::repeat(6)[h16 >> ':'] >> ls32)
-
-            | (                                       "::" >> x3::repeat(5)[h16 >> ':'] >> ls32)
-
-            | (-(                             h16) >> "::" >> x3::repeat(4)[h16 >> ':'] >> ls32)
-
-            | (-(                             h16) >> "::" >> x3::repeat(3)[h16 >> ':'] >> ls32)
-            | (-(              h16 >> ':'  >> h16) >> "::" >> x3::repeat(3)[h16 >> ':'] >> ls32)
-
-            | (-(                             h16) >> "::" >> x3::repeat(2)[h16 >> ':'] >> ls32)
-            | (-(              h16 >> ':'  >> h16) >> "::" >> x3::repeat(2)[h16 >> ':'] >> ls32)
-            | (-(x3::repeat(2)[h16 >> ':'] >> h16) >> "::" >> x3::repeat(2)[h16 >> ':'] >> ls32)
-
-            | (-(                             h16) >> "::" >>               h16 >> ':'  >> ls32)
-            | (-(              h16 >> ':'  >> h16) >> "::" >>               h16 >> ':'  >> ls32)
-            | (-(x3::repeat(2)[h16 >> ':'] >> h16) >> "::" >>               h16 >> ':'  >> ls32)
-            | (-(x3::repeat(3)[h16 >> ':'] >> h16) >> "::" >>               h16 >> ':'  >> ls32)
-
-            | (-(                             h16) >> "::" >>                              ls32)
-            | (-(              h16 >> ':'  >> h16) >> "::" >>                              ls32)
-            | (-(x3::repeat(2)[h16 >> ':'] >> h16) >> "::" >>                              ls32)
-            | (-(x3::repeat(3)[h16 >> ':'] >> h16) >> "::" >>                              ls32)
-            | (-(x3::repeat(4)[h16 >> ':'] >> h16) >> "::" >>                              ls32)
-
-            | (-(                             h16) >> "::" >>                              h16 )
-            | (-(              h16 >> ':'  >> h16) >> "::" >>                              h16 )
-            | (-(x3::repeat(2)[h16 >> ':'] >> h16) >> "::" >>                              h16 )
-            | (-(x3::repeat(3)[h16 >> ':'] >> h16) >> "::" >>                              h16 )
-            | (-(x3::repeat(4)[h16 >> ':'] >> h16) >> "::" >>                              h16 )
-            | (-(x3::repeat(5)[h16 >> ':'] >> h16) >> "::" >>                              h16 )
-
-            | (-(                             h16) >> "::"                                     )
-            | (-(              h16 >> ':'  >> h16) >> "::"                                     )
-            | (-(x3::repeat(2)[h16 >> ':'] >> h16) >> "::"                                     )
-            | (-(x3::repeat(3)[h16 >> ':'] >> h16) >> "::"                                     )
-            | (-(x3::repeat(4)[h16 >> ':'] >> h16) >> "::"                                     )
-            | (-(x3::repeat(5)[h16 >> ':'] >> h16) >> "::"                                     )
-            | (-(x3::repeat(6)[h16 >> ':'] >> h16) >> "::"                                     )
-        ) >>
-        -('%' >> *pchar); // и это отступление от спеки
+    //
+    // Альтернативы с "*n(" развернуты в n+1 штук с фиксированным префиксом и
+    // перебираются в том же порядке, что и прежде: побеждает первая совпавшая.
+    enum class Ip6Tail
+    {
+        ls32,
+        h16,
+        none,
+    };
 
-    // IPvFuture  = "v" 1*HEXDIG "." 1*( unreserved / sub-delims / ":" )
-    const auto ipFuture = 'v' >> +hexDig >> '.' >> +(unreserved | subDelims | ':') >> -('%' >> *pchar);
+    struct Ip6Alt
+    {
+        int     _prefix;    // -2: без "::", -1: "::" без префикса, n: [ n( h16 ":" ) h16 ] "::"
+        int     _repeat;    // n( h16 ":" ) после "::"
+        Ip6Tail _tail;
+    };
 
-    // IP-literal = "[" ( IPv6address / IPvFuture  ) "]"
-    const auto ipLiteral = '[' >> (ip6 | ipFuture) >> ']';
+    constexpr Ip6Alt ip6Alts[] =
+    {
+        {-2, 6, Ip6Tail::ls32},
+        {-1, 5, Ip6Tail::ls32},
+        { 0, 4, Ip6Tail::ls32},
+        { 0, 3, Ip6Tail::ls32}, {1, 3, Ip6Tail::ls32},
+        { 0, 2, Ip6Tail::ls32}, {1, 2, Ip6Tail::ls32}, {2, 2, Ip6Tail::ls32},
+        { 0, 1, Ip6Tail::ls32}, {1, 1, Ip6Tail::ls32}, {2, 1, Ip6Tail::ls32}, {3, 1, Ip6Tail::ls32},
+        { 0, 0, Ip6Tail::ls32}, {1, 0, Ip6Tail::ls32}, {2, 0, Ip6Tail::ls32}, {3, 0, Ip6Tail::ls32}, {4, 0, Ip6Tail::ls32},
+        { 0, 0, Ip6Tail::h16 }, {1, 0, Ip6Tail::h16 }, {2, 0, Ip6Tail::h16 }, {3, 0, Ip6Tail::h16 }, {4, 0, Ip6Tail::h16 }, {5, 0, Ip6Tail::h16 },
+        { 0, 0, Ip6Tail::none}, {1, 0, Ip6Tail::none}, {2, 0, Ip6Tail::none}, {3, 0, Ip6Tail::none}, {4, 0, Ip6Tail::none}, {5, 0, Ip6Tail::none}, {6, 0, Ip6Tail::none},
+    };
 
-    // reg-name    = *( unreserved / pct-encoded / sub-delims )
-    const auto regName = +(unreserved | pctEncoded | subDelims);// тут отклонение от спецификации, дополнительно потребуем непустоту
+    const char* ip6(const char* p, const char* e)
+    {
+        for(const Ip6Alt& alt : ip6Alts)
+        {
+            const char* q = p;
 
-    // host        = IP-literal / IPv4address / reg-name
-    const auto host = ip4 | ipLiteral | regName;
+            if(alt._prefix >= 0)
+            {
+                const char* r = q;
+                for(int i{}; i < alt._prefix && r; ++i)
+                    r = h16Colon(r, e);
+                if(r)
+                    r = h16(r, e);
+                if(r)
+                    q = r;
+            }
 
-    //  port        = *DIGIT
-    const auto port = *digit;
+            if(-2 != alt._prefix)
+                q = (e - q >= 2 && ':' == q[0] && ':' == q[1]) ? q + 2 : nullptr;
 
-    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    // segment       = *pchar
-    const auto segment = *pchar;
+            for(int i{}; i < alt._repeat && q; ++i)
+                q = h16Colon(q, e);
 
-    // segment-nz    = 1*pchar
-    const auto segmentNz = +pchar;
+            if(q)
+            {
+                switch(alt._tail)
+                {
+                case Ip6Tail::ls32: q = ls32(q, e); break;
+                case Ip6Tail::h16:  q = h16(q, e);  break;
+                case Ip6Tail::none:                 break;
+                }
+            }
 
-    // segment-nz-nc = 1*( unreserved / pct-encoded / sub-delims / "@" )
-    //               ; non-zero-length segment without any colon ":"
-    const auto segmentNzNc = +(unreserved | pctEncoded | subDelims | '@');
+            if(q)
+                return zone(q, e);
+        }
 
-    // path-abempty  = *( "/" segment )
-    const auto pathAbempty = *('/' >> segment);
+        return nullptr;
+    }
 
-    // path-absolute = "/" [ segment-nz *( "/" segment ) ]
-    const auto pathAbsolute = '/' >> -(segmentNz >> *('/' >> segment));
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // IPvFuture  = "v" 1*HEXDIG "." 1*( unreserved / sub-delims / ":" )
+    const char* ipFuture(const char* p, const char* e)
+    {
+        if(p == e || 'v' != *p)
+            return nullptr;
 
-    // path-noscheme = segment-nz-nc *( "/" segment )
-    const auto pathNoscheme = segmentNzNc >> *('/' >> segment);
+        const char* q = scan(p + 1, e, ccHexDig);
+        if(q == p + 1 || q == e || '.' != *q)
+            return nullptr;
 
-    // path-rootless = segment-nz *( "/" segment )
-    const auto pathRootless = segmentNz >> *('/' >> segment);
+        const char* r = scan(q + 1, e, ccUnreserved | ccSubDelims | ccColon);
+        if(r == q + 1)
+            return nullptr;
 
-    // path-empty    = 0<pchar>
-    const auto pathEmpty = x3::eps;
+        return zone(r, e);
+    }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    // path          = path-abempty    ; begins with "/" or is empty
-    //               / path-absolute   ; begins with "/" but not "//"
-    //               / path-noscheme   ; begins with a non-colon segment
-    //               / path-rootless   ; begins with a segment
-    //               / path-empty      ; zero characters
-    const auto path = pathAbempty | pathAbsolute | pathNoscheme | pathRootless | pathEmpty;
+    enum class HostGrammar
+    {
+        any,    // host = IP-literal / IPv4address / reg-name
+        ip4,    //        IPv4address / reg-name
+        ip6,    //        IP-literal / reg-name
+    };
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <typename T> auto as = [](auto name, auto p) { return x3::rule<struct _, T> {name} = p; };
+    // Для IP-literal возвращается конец вместе с "]", сам адрес - без скобок.
+    //
+    // IPv4address разбирается как начало reg-name (его символы - подмножество символов
+    // reg-name). Если он не покрыл reg-name целиком, то следующий символ не может
+    // начать ни порт, ни путь, и прежняя грамматика повторяла разбор хоста как reg-name -
+    // здесь это решается сразу, без второго прохода.
+    const char* host(const char* p, const char* e, HostGrammar grammar, HostKind& kind)
+    {
+        if(p != e && '[' == *p)
+        {
+            if(HostGrammar::ip4 == grammar)
+                return nullptr;
 
-    template <class String>
-    const auto r_userinfo = as<www::Userinfo<String>>("userinfo", x3::raw[username] >> -(':' >> x3::raw[userpasswd]));
+            // IP-literal = "[" ( IPv6address / IPvFuture  ) "]"
+            if(const char* q = ip6(p + 1, e); q && q != e && ']' == *q)
+            {
+                kind = HostKind::ip6;
+                return q + 1;
+            }
 
-    template <class String>
-    const auto r_ip4 = as<networkNode::Ip4<String>>("ip4", x3::raw[ip4]);
+            if(const char* q = ipFuture(p + 1, e); q && q != e && ']' == *q)
+            {
+                kind = HostKind::ipFuture;
+                return q + 1;
+            }
 
-    template <class String>
-    const auto r_ip6 = as<networkNode::Ip6<String>>("ip6", x3::raw[ip6]);
+            return nullptr;
+        }
 
-    template <class String>
-    const auto r_ipFuture = as<networkNode::IpFuture<String>>("ipFuture", x3::raw[ipFuture]);
+        // reg-name    = *( unreserved / pct-encoded / sub-delims )
+        const char* q = scanPct(p, e, regNameSet);
+        if(q == p)
+            return nullptr;// тут отклонение от спецификации, дополнительно потребуем непустоту
 
-    template <class String>
-    const auto r_regName = as<networkNode::RegName<String>>("regName", x3::raw[regName]);
+        kind = (HostGrammar::ip6 != grammar && ip4(p, e) == q) ? HostKind::ip4 : HostKind::regName;
+        return q;
+    }
 
-    template <class String>
-    const auto r_host = as<networkNode::Host<String>>("host", r_ip4<String> | ('[' >> r_ip6<String> >> ']') | ('[' >> r_ipFuture<String> >> ']') | r_regName<String>);
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    const char* slashes(const char* p, const char* e)
+    {
+        return (e - p >= 2 && '/' == p[0] && '/' == p[1]) ? p + 2 : nullptr;
+    }
 
-    template <class String>
-    const auto r_host4 = as<networkNode::Host<String>>("host", r_ip4<String> | r_regName<String>);
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // path-abempty  = *( "/" segment )
+    const char* pathAbempty(const char* p, const char* e)
+    {
+        return (p != e && '/' == *p) ? scanPct(p, e, pathSet) : p;
+    }
 
-    template <class String>
-    const auto r_host6 = as<networkNode::Host<String>>("host", ('[' >> r_ip6<String> >> ']') | ('[' >> r_ipFuture<String> >> ']') | r_regName<String>);
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // path-absolute = "/" [ segment-nz *( "/" segment ) ]
+    const char* pathAbsolute(const char* p, const char* e)
+    {
+        if(p == e || '/' != *p)
+            return nullptr;
+
+        const char* q = scanPct(p + 1, e, pcharSet);
+        return q == p + 1 ? q : scanPct(q, e, pathSet);
+    }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::Mailto<String>& val)
+    // участок исходной строки, _begin == nullptr - компонента нет
+    struct Range
     {
-        val._value = val._hierPart;
-        return true;
+        const char* _begin{};
+        const char* _end{};
+
+        bool present() const
+        {
+            return _begin;
+        }
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // результат сканирования - только границы компонент, без строк и variant; из него
+    // собирается URI<String> или строка пакетного результата
+    struct Parsed
+    {
+        Kind        _kind{};
+        Range       _scheme;
+        Range       _hierPart;
+        Range       _query;
+        Range       _fragment;
+
+        Range       _auth;      // inproc, local, file: authority как есть
+        Range       _userName;  // www: есть, если есть userinfo
+        Range       _password;
+        HostKind    _hostKind{};
+        Range       _host;      // tcp, udp, www: без скобок IP-literal
+        Range       _port;
+        Range       _path;      // file, www
+    };
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // hierPart для каждой схемы: разбор с p и до первого символа, не подошедшего по
+    // грамматике. Ни одно из правил не принимает '?' и '#', так что успешный разбор
+    // останавливается ровно на конце hierPart.
+    const char* anyHierPart(const char* p, const char* e)
+    {
+        return charScan::find(p, e, hierPartEndSet);
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::Inproc<String>& val)
+    // "//" *char
+    const char* inprocHierPart(const char* p, const char* e, Parsed& dst)
     {
-        auto parseArtefact = std::tie(val._auth);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           x3::raw[*x3::char_] >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-        return res;
+        p = slashes(p, e);
+        if(!p)
+            return nullptr;
+
+        const char* q = anyHierPart(p, e);
+        dst._auth = {p, q};
+        return q;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::Local<String>& val)
+    // "//" [ host ] path-absolute
+    const char* fileHierPart(const char* p, const char* e, Parsed& dst)
     {
-        auto parseArtefact = std::tie(val._auth);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           x3::raw[*x3::char_] >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-        return res;
+        p = slashes(p, e);
+        if(!p)
+            return nullptr;
+
+        if(const char* q = host(p, e, HostGrammar::any, dst._hostKind))
+        {
+            // без повторного разбора как reg-name: ip4 обрывается на символе, с которого не начинается путь
+            if(HostKind::regName == dst._hostKind && ip4(p, e))
+                return nullptr;
+
+            dst._auth = {p, q};
+            p = q;
+        }
+
+        const char* q = pathAbsolute(p, e);
+        if(!q)
+            return nullptr;
+
+        dst._path = {p, q};
+        return q;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::File<String>& val)
+    // host [ ":" port ], port = *DIGIT
+    const char* nodeAddress(const char* p, const char* e, HostGrammar grammar, Parsed& dst)
     {
-        auto parseArtefact = std::tie(val._auth, val._path);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           -x3::raw[host] >>
-                           x3::raw[pathAbsolute] >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-        return res;
+        const char* q = host(p, e, grammar, dst._hostKind);
+        if(!q)
+            return nullptr;
+
+        dst._host = (HostKind::ip6 == dst._hostKind || HostKind::ipFuture == dst._hostKind) ? Range{p + 1, q - 1} : Range{p, q};
+
+        if(q == e || ':' != *q)
+            return q;
+
+        const char* r = scan(q + 1, e, ccDigit);
+        dst._port = {q + 1, r};
+        return r;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <template <class> class Alt, class String>
-    requires (std::is_same_v<uri::TCP<String>, Alt<String>> || std::is_same_v<uri::UDP<String>, Alt<String>>)
-    bool phase2(Alt<String>& val)
-    {
-        auto parseArtefact = std::tie(val._auth._host, val._auth._port);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           r_host<String> >>
-                           -(':' >> x3::raw[port]) >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-
-        if(!res && std::holds_alternative<uri::networkNode::Ip4<String>>(val._auth._host))
-        {
-            // вторая попытка отпарсить урл для случаев плохого префикса ip4, например 0.0.0.256. Такой конструкт должен быть расопзнан как regName
-            res = x3::parse(
-                           val._hierPart.begin(), val._hierPart.end(),
-                           (
-                               x3::lit("//") >>
-                               r_regName<String> >>
-                               -(':' >> x3::raw[port]) >>
-                               x3::eoi
-                           ),
-                           parseArtefact);
+    // "//" host [ ":" port ]
+    const char* nodeHierPart(const char* p, const char* e, HostGrammar grammar, Parsed& dst)
+    {
+        p = slashes(p, e);
+        if(!p)
+            return nullptr;
+
+        return nodeAddress(p, e, grammar, dst);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // "//" [ userinfo "@" ] host [ ":" port ] path-abempty
+    const char* wwwHierPart(const char* p, const char* e, Parsed& dst)
+    {
+        p = slashes(p, e);
+        if(!p)
+            return nullptr;
+
+        // userinfo    = *( unreserved / pct-encoded / sub-delims / ":" ), первое ":" отделяет пароль
+        {
+            const char* nameEnd = scanPct(p, e, regNameSet);
+            const char* q = nameEnd;
+            if(q != e && ':' == *q)
+                q = scanPct(q + 1, e, userpasswdSet);
+
+            if(q != e && '@' == *q)
+            {
+                dst._userName = {p, nameEnd};
+                if(nameEnd != q)
+                    dst._password = {nameEnd + 1, q};
+                p = q + 1;
+            }
         }
 
-        return res;
+        p = nodeAddress(p, e, HostGrammar::any, dst);
+        if(!p)
+            return nullptr;
+
+        const char* q = pathAbempty(p, e);
+        dst._path = {p, q};
+        return q;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <template <class> class Alt, class String>
-    requires (std::is_same_v<uri::TCP4<String>, Alt<String>> || std::is_same_v<uri::UDP4<String>, Alt<String>>)
-    bool phase2(Alt<String>& val)
+    static_assert(std::is_same_v<uri::Unknown<>,   std::variant_alternative_t<static_cast<std::size_t>(Kind::unknown), URI<>>>);
+    static_assert(std::is_same_v<uri::Mailto<>,    std::variant_alternative_t<static_cast<std::size_t>(Kind::mailto),  URI<>>>);
+    static_assert(std::is_same_v<uri::TCP6<>,      std::variant_alternative_t<static_cast<std::size_t>(Kind::tcp6),    URI<>>>);
+    static_assert(std::is_same_v<uri::FTPS<>,      std::variant_alternative_t<static_cast<std::size_t>(Kind::ftps),    URI<>>>);
+    static_assert(std::variant_size_v<URI<>> == static_cast<std::size_t>(Kind::ftps) + 1);
+
+    static_assert(std::is_same_v<networkNode::Ip6<>,     std::variant_alternative_t<static_cast<std::size_t>(HostKind::ip6),      networkNode::Host<>>>);
+    static_assert(std::is_same_v<networkNode::RegName<>, std::variant_alternative_t<static_cast<std::size_t>(HostKind::regName),  networkNode::Host<>>>);
+
+    constexpr auto schemes = perfectHash<Kind>({
+        {"inproc",  Kind::inproc},
+        {"local",   Kind::local},
+        {"tcp",     Kind::tcp},
+        {"tcp4",    Kind::tcp4},
+        {"tcp6",    Kind::tcp6},
+        {"udp",     Kind::udp},
+        {"udp4",    Kind::udp4},
+        {"udp6",    Kind::udp6},
+        {"mailto",  Kind::mailto},
+        {"file",    Kind::file},
+        {"ftp",     Kind::ftp},
+        {"ftps",    Kind::ftps},
+        {"http",    Kind::http},
+        {"https",   Kind::https},
+    });
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // scheme ":" hierPart [ "?" query ] [ "#" fragment ]. При неудаче разбора hierPart
+    // generic-часть все равно заполняется, как и прежде
+    bool scanUri(std::string_view src, Parsed& dst)
     {
-        auto parseArtefact = std::tie(val._auth._host, val._auth._port);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           r_host4<String> >>
-                           -(':' >> x3::raw[port]) >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
+        const char* b = src.data();
+        const char* e = b + src.size();
+
+        // scheme      = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." )
+        const char* schemeEnd = (b != e && is(*b, ccAlpha)) ? scan(b + 1, e, ccScheme) : e;
+        if(schemeEnd == e || ':' != *schemeEnd)
+        {
+            dst._kind = Kind::unknown;
+            return false;
+        }
+
+        const char* hierBegin = schemeEnd + 1;
+        dst._scheme = {b, schemeEnd};
+
+        if(const Kind* known = schemes.find(std::string_view{b, static_cast<std::size_t>(schemeEnd - b)}))
+            dst._kind = *known;
+        else
+            dst._kind = slashes(hierBegin, e) ? Kind::www : Kind::generic;
+
+        const char* hierEnd{};
+        switch(dst._kind)
+        {
+        case Kind::unknown:
+        case Kind::generic:
+        case Kind::mailto:  hierEnd = anyHierPart(hierBegin, e); break;
+
+        case Kind::inproc:
+        case Kind::local:   hierEnd = inprocHierPart(hierBegin, e, dst); break;
+
+        case Kind::file:    hierEnd = fileHierPart(hierBegin, e, dst); break;
+
+        case Kind::tcp:
+        case Kind::udp:     hierEnd = nodeHierPart(hierBegin, e, HostGrammar::any, dst); break;
+
+        case Kind::tcp4:
+        case Kind::udp4:    hierEnd = nodeHierPart(hierBegin, e, HostGrammar::ip4, dst); break;
 
+        case Kind::tcp6:
+        case Kind::udp6:    hierEnd = nodeHierPart(hierBegin, e, HostGrammar::ip6, dst); break;
+
+        case Kind::www:
+        case Kind::http:
+        case Kind::https:
+        case Kind::ftp:
+        case Kind::ftps:    hierEnd = wwwHierPart(hierBegin, e, dst); break;
+        }
+
+        bool res = hierEnd && (hierEnd == e || '?' == *hierEnd || '#' == *hierEnd);
         if(!res)
+            hierEnd = anyHierPart(hierBegin, e);
+
+        dst._hierPart = {hierBegin, hierEnd};
+
+        const char* p = hierEnd;
+        if(p != e && '?' == *p)
         {
-            // вторая попытка отпарсить урл для случаев плохого префикса ip4, например 0.0.0.256. Такой конструкт должен быть расопзнан как regName
-            res = x3::parse(
-                           val._hierPart.begin(), val._hierPart.end(),
-                           (
-                               x3::lit("//") >>
-                               r_regName<String> >>
-                               -(':' >> x3::raw[port]) >>
-                               x3::eoi
-                           ),
-                           parseArtefact);
+            const char* q = charScan::find(p + 1, e, queryEndSet);
+            dst._query = {p + 1, q};
+            p = q;
         }
 
+        if(p != e)
+            dst._fragment = {p + 1, e};
+
         return res;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <template <class> class Alt, class String>
-    requires (std::is_same_v<uri::TCP6<String>, Alt<String>> || std::is_same_v<uri::UDP6<String>, Alt<String>>)
-    bool phase2(Alt<String>& val)
+    // аллокатор строк результата; у std::string_view и std::string - свой собственный
+    struct NoAlloc {};
+
+    template <class String, class Alloc>
+    String str(Range range, const Alloc& alloc)
     {
-        auto parseArtefact = std::tie(val._auth._host, val._auth._port);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           r_host6<String> >>
-                           -(':' >> x3::raw[port]) >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
+        std::size_t size = static_cast<std::size_t>(range._end - range._begin);
 
-        return res;
+        if constexpr(std::is_same_v<NoAlloc, Alloc>)
+            return String(range._begin, size);
+        else
+            return String(range._begin, size, alloc);
+    }
+
+    template <class String, class Alloc>
+    String empty(const Alloc& alloc)
+    {
+        if constexpr(std::is_same_v<NoAlloc, Alloc>)
+            return String{};
+        else
+            return String(alloc);
+    }
+
+    template <class String, class Alloc>
+    std::optional<String> optStr(Range range, const Alloc& alloc)
+    {
+        if(!range.present())
+            return {};
+        return str<String>(range, alloc);
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::WWW<String>& val)
-    {
-        auto parseArtefact = std::tie(val._auth._userinfo, val._auth._networkNode._host, val._auth._networkNode._port, val._path);
-        bool res = x3::parse(
-                       val._hierPart.begin(), val._hierPart.end(),
-                       (
-                           x3::lit("//") >>
-                           ((r_userinfo<String> >> '@') | x3::eps[([&]{ val._auth._userinfo = {}; })]) >> // https://github.com/boostorg/spirit/issues/378
-                           r_host<String> >>
-                           -(':' >> x3::raw[port]) >>
-                           x3::raw[path] >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-
-        if(!res && std::holds_alternative<uri::networkNode::Ip4<String>>(val._auth._networkNode._host))
-        {
-            // вторая попытка отпарсить урл для случаев плохого префикса ip4, например 0.0.0.256. Такой конструкт должен быть расопзнан как regName
-            res = x3::parse(
-                           val._hierPart.begin(), val._hierPart.end(),
-                           (
-                               x3::lit("//") >>
-                               ((r_userinfo<String> >> '@') | x3::eps[([&]{ val._auth._userinfo = {}; })]) >>
-                               r_regName<String> >>
-                               -(':' >> x3::raw[port]) >>
-                               x3::raw[path] >>
-                               x3::eoi
-                           ),
-                           parseArtefact);
+    template <class String, class Alloc>
+    networkNode::Host<String> mkHost(HostKind kind, Range range, const Alloc& alloc)
+    {
+        switch(kind)
+        {
+        case HostKind::ip4:         return networkNode::Ip4<String>{str<String>(range, alloc)};
+        case HostKind::ip6:         return networkNode::Ip6<String>{str<String>(range, alloc)};
+        case HostKind::ipFuture:    return networkNode::IpFuture<String>{str<String>(range, alloc)};
+        case HostKind::regName:     break;
         }
 
-        return res;
+        return networkNode::RegName<String>{str<String>(range, alloc)};
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::HTTP<String>& val)
+    // альтернатива собирается целиком, без присваиваний: перемещающее присваивание
+    // строк с неравными аллокаторами (std::pmr) копирует в аллокатор приемника, а
+    // перемещающее конструирование забирает аллокатор вместе с буфером.
+    // Специфичная для схемы часть заполняется только при успешном разборе
+    template <class Alt, class String, class Alloc>
+    Alt make(const Parsed& in, bool res, const Alloc& alloc)
     {
-        return phase2(static_cast<uri::WWW<String>&>(val));
+        Generic<String> generic
+        {
+            str<String>(in._scheme, alloc),
+            str<String>(in._hierPart, alloc),
+            optStr<String>(in._query, alloc),
+            optStr<String>(in._fragment, alloc),
+        };
+
+        // при неудаче специфичная часть пуста, но строки в ней - тоже от alloc
+        auto node = [&]
+        {
+            if(!res)
+                return NetworkNode<String>{networkNode::Ip4<String>{empty<String>(alloc)}, std::nullopt};
+            return NetworkNode<String>{mkHost<String>(in._hostKind, in._host, alloc), optStr<String>(in._port, alloc)};
+        };
+
+        if constexpr(std::is_same_v<Generic<String>, Alt>)
+            return generic;
+
+        else if constexpr(std::is_same_v<Mailto<String>, Alt>)
+            return Alt{std::move(generic), res ? str<String>(in._hierPart, alloc) : empty<String>(alloc)};
+
+        else if constexpr(std::is_same_v<Inproc<String>, Alt> || std::is_same_v<Local<String>, Alt>)
+            return Alt{std::move(generic), res ? str<String>(in._auth, alloc) : empty<String>(alloc)};
+
+        else if constexpr(std::is_same_v<File<String>, Alt>)
+            return Alt{std::move(generic), res ? optStr<String>(in._auth, alloc) : std::nullopt, res ? str<String>(in._path, alloc) : empty<String>(alloc)};
+
+        else if constexpr(std::is_base_of_v<TCP<String>, Alt> || std::is_base_of_v<UDP<String>, Alt>)
+        {
+            using Base = std::conditional_t<std::is_base_of_v<TCP<String>, Alt>, TCP<String>, UDP<String>>;
+
+            Base base{std::move(generic), node()};
+
+            if constexpr(std::is_same_v<Base, Alt>)
+                return base;
+            else
+                return Alt{std::move(base)};
+        }
+
+        else
+        {
+            static_assert(std::is_base_of_v<WWW<String>, Alt>);
+
+            std::optional<www::Userinfo<String>> userinfo;
+            if(res && in._userName.present())
+                userinfo.emplace(www::Userinfo<String>{str<String>(in._userName, alloc), optStr<String>(in._password, alloc)});
+
+            WWW<String> base
+            {
+                std::move(generic),
+                www::Authority<String>{std::move(userinfo), node()},
+                res ? str<String>(in._path, alloc) : empty<String>(alloc),
+            };
+
+            if constexpr(std::is_same_v<WWW<String>, Alt>)
+                return base;
+            else
+                return Alt{std::move(base)};
+        }
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::HTTPS<String>& val)
+    template <class Alt, class String, class Alloc>
+    bool build(const Parsed& in, bool res, URI<String>& dst, const Alloc& alloc)
     {
-        return phase2(static_cast<uri::WWW<String>&>(val));
+        dst.template emplace<Alt>(make<Alt, String>(in, res, alloc));
+        return res;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::FTP<String>& val)
+    template <class String, class Alloc = NoAlloc>
+    bool parseImpl(std::string_view src, URI<String>& dst, const Alloc& alloc = {})
     {
-        return phase2(static_cast<uri::WWW<String>&>(val));
+        Parsed parsed;
+        bool res = scanUri(src, parsed);
+
+        switch(parsed._kind)
+        {
+        case Kind::unknown: dst.template emplace<Unknown<String>>(Unknown<String>{str<String>({src.data(), src.data() + src.size()}, alloc)}); return false;
+        case Kind::generic: return build<Generic<String>>(parsed, res, dst, alloc);
+        case Kind::mailto:  return build<Mailto<String>>(parsed, res, dst, alloc);
+        case Kind::inproc:  return build<Inproc<String>>(parsed, res, dst, alloc);
+        case Kind::local:   return build<Local<String>>(parsed, res, dst, alloc);
+        case Kind::file:    return build<File<String>>(parsed, res, dst, alloc);
+        case Kind::tcp:     return build<TCP<String>>(parsed, res, dst, alloc);
+        case Kind::tcp4:    return build<TCP4<String>>(parsed, res, dst, alloc);
+        case Kind::tcp6:    return build<TCP6<String>>(parsed, res, dst, alloc);
+        case Kind::udp:     return build<UDP<String>>(parsed, res, dst, alloc);
+        case Kind::udp4:    return build<UDP4<String>>(parsed, res, dst, alloc);
+        case Kind::udp6:    return build<UDP6<String>>(parsed, res, dst, alloc);
+        case Kind::www:     return build<WWW<String>>(parsed, res, dst, alloc);
+        case Kind::http:    return build<HTTP<String>>(parsed, res, dst, alloc);
+        case Kind::https:   return build<HTTPS<String>>(parsed, res, dst, alloc);
+        case Kind::ftp:     return build<FTP<String>>(parsed, res, dst, alloc);
+        case Kind::ftps:    return build<FTPS<String>>(parsed, res, dst, alloc);
+        }
+
+        return false;
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-    template <class String>
-    bool phase2(uri::FTPS<String>& val)
+    Slice slice(const char* base, Range range)
     {
-        return phase2(static_cast<uri::WWW<String>&>(val));
+        if(!range.present())
+            return {};
+        return {static_cast<std::uint32_t>(range._begin - base), static_cast<std::uint32_t>(range._end - range._begin)};
     }
-}
 
-namespace
-{
-    template <class Src, class DstString>
-    bool phase1(const Src& src, URI<DstString>& dst)
-    {
-        uri::Generic<DstString> generic;
-        auto parseArtefact = std::tie(generic._scheme, generic._hierPart, generic._query, generic._fragment);
-        bool res = x3::parse(
-                       src.begin(), src.end(),
-                       (
-                           x3::raw[x3::alpha >> *(x3::alnum|'+'|'-'|'.')] >> ':' >>
-                           x3::raw[*(x3::char_-'?'-'#')] >>
-                           -('?' >> x3::raw[*(x3::char_-'#')]) >>
-                           -('#' >> x3::raw[*x3::char_]) >>
-                           x3::eoi
-                       ),
-                       parseArtefact);
-
-        if(!res)
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void parseBatchRange(std::span<const std::string_view> srcs, Batch& dst, std::size_t begin, std::size_t end)
+    {
+        for(std::size_t i{begin}; i<end; ++i)
         {
-            dst = uri::Unknown<DstString>{DstString{src}};
-            return false;
-        }
+            std::string_view src = srcs[i];
 
-        switch(generic._scheme[0])
-        {
-        case 'i': //inproc
-            if(6 == generic._scheme.size())
-            {
-                if("inproc"sv == generic._scheme)
-                    return phase2(dst.template emplace<Inproc<DstString>>(std::move(generic)));
-            }
-            break;
-        case 'l': //local
-            if(5 == generic._scheme.size())
-            {
-                if("local"sv == generic._scheme)
-                    return phase2(dst.template emplace<Local<DstString>>(std::move(generic)));
-            }
-            break;
-        case 't': //tcp, tcp4, tcp6
-            if(3 == generic._scheme.size())
-            {
-                if("tcp"sv == generic._scheme)
-                    return phase2(dst.template emplace<TCP<DstString>>(std::move(generic)));
-                break;
-            }
-            else if(4 == generic._scheme.size())
+            dst._scheme[i] = dst._host[i] = dst._port[i] = dst._path[i] = dst._query[i] = dst._fragment[i] = Slice{};
+
+            if(src.size() >= Slice::absent)
             {
-                switch(generic._scheme[3])
-                {
-                case '4':
-                    if("tcp4"sv == generic._scheme)
-                        return phase2(dst.template emplace<TCP4<DstString>>(TCP<DstString>{std::move(generic)}));
-                    break;
-                case '6':
-                    if("tcp6"sv == generic._scheme)
-                        return phase2(dst.template emplace<TCP6<DstString>>(TCP<DstString>{std::move(generic)}));
-                    break;
-                }
+                dst._kind[i] = Kind::unknown;
+                dst._status[i] = Batch::Status::tooLong;
+                continue;
             }
-            break;
-        case 'u': //udp, udp4, udp6
-            if(3 == generic._scheme.size())
+
+            Parsed parsed;
+            bool res = scanUri(src, parsed);
+
+            dst._kind[i] = parsed._kind;
+            dst._status[i] = res ? Batch::Status::ok : Batch::Status::malformed;
+
+            const char* base = src.data();
+            dst._scheme[i] = slice(base, parsed._scheme);
+            dst._query[i] = slice(base, parsed._query);
+            dst._fragment[i] = slice(base, parsed._fragment);
+
+            if(!res)
+                continue;
+
+            dst._host[i] = slice(base, parsed._host.present() ? parsed._host : parsed._auth);
+            dst._port[i] = slice(base, parsed._port);
+            dst._path[i] = slice(base, parsed._path);
+        }
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // то, что нужно scheme/host/hostPort/isCover от строки, - смещениями в этой строке,
+    // чтобы один и тот же результат годился для любой копии строки
+    struct Summary
+    {
+        struct Part
+        {
+            std::size_t _begin{};
+            std::size_t _end{};
+
+            std::string_view of(std::string_view src) const
             {
-                if("udp"sv == generic._scheme)
-                    return phase2(dst.template emplace<UDP<DstString>>(std::move(generic)));
-                break;
+                return src.substr(_begin, _end - _begin);
             }
-            else if(4 == generic._scheme.size())
+        };
+
+        bool _valid{};
+        Kind _kind{};
+        Part _scheme;
+        Part _host;
+        Part _hostPort;
+    };
+
+    Summary summarize(std::string_view src)
+    {
+        Parsed parsed;
+        Summary res;
+        res._valid = scanUri(src, parsed);
+        res._kind = parsed._kind;
+
+        if(!res._valid)
+            return res;
+
+        auto part = [&](const char* begin, const char* end)
+        {
+            return Summary::Part{static_cast<std::size_t>(begin - src.data()), static_cast<std::size_t>(end - src.data())};
+        };
+
+        res._scheme = part(parsed._scheme._begin, parsed._scheme._end);
+
+        if(Kind::file == parsed._kind)
+        {
+            if(parsed._auth.present())
+                res._host = res._hostPort = part(parsed._auth._begin, parsed._auth._end);
+        }
+        else if(Kind::inproc != parsed._kind && Kind::local != parsed._kind && parsed._host.present())
+        {
+            // hostPort - как есть в исходной строке: IP-literal в скобках, затем ":" port
+            std::size_t brackets = (HostKind::ip6 == parsed._hostKind || HostKind::ipFuture == parsed._hostKind) ? 1 : 0;
+            res._host = part(parsed._host._begin, parsed._host._end);
+            res._hostPort = part(parsed._host._begin - brackets, parsed._port.present() ? parsed._port._end : parsed._host._end + brackets);
+        }
+
+        return res;
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // inproc < local < ip < regname
+    bool isCoverSummary(Kind baseKind, std::string_view baseHost, Kind targetKind, std::string_view targetHost)
+    {
+        if(Kind::inproc == baseKind)
+            return true;
+
+        if(Kind::inproc == targetKind)
+            return false;
+
+        if(Kind::local == baseKind)
+            return true;
+
+        if(Kind::local == targetKind)
+            return false;
+
+        // ip::fromString заглядывает в символ за концом строки (asciiz?), пустому хосту
+        // (у generic, mailto и т.п. - std::string_view{} с nullptr) нужен настоящий адрес
+        if(baseHost.empty())
+            baseHost = ""sv;
+        if(targetHost.empty())
+            targetHost = ""sv;
+
+        return ip::isCover(baseHost, targetHost);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // Кэш Summary по исходной строке, ключ - fnv1a от строки (FlatHash). Вытеснение CLOCK:
+    // при попадании у слота ставится признак обращения, стрелка при вытеснении пропускает
+    // (и сбрасывает) отмеченные слоты. Разбор при промахе - вне блокировки
+    class SummaryCache
+    {
+    public:
+        Summary get(std::string_view src)
+        {
+            if(!_capacity.load(std::memory_order_relaxed))
+                return summarize(src);
+
             {
-                switch(generic._scheme[3])
+                std::lock_guard lock{_mtx};
+                if(auto iter = _index.find(src); _index.end() != iter)
                 {
-                case '4':
-                    if("udp4"sv == generic._scheme)
-                        return phase2(dst.template emplace<UDP4<DstString>>(UDP<DstString>{std::move(generic)}));
-                    break;
-                case '6':
-                    if("udp6"sv == generic._scheme)
-                        return phase2(dst.template emplace<UDP6<DstString>>(UDP<DstString>{std::move(generic)}));
-                    break;
+                    Slot& slot = _slots[iter->second];
+                    slot._referenced = true;
+                    ++_hits;
+                    return slot._summary;
                 }
+                ++_misses;
             }
-            break;
-        case 'm': //mailto
-            if("mailto"sv == generic._scheme)
-                return phase2(dst.template emplace<Mailto<DstString>>(std::move(generic)));
-            break;
-        case 'f': //file, ftp, ftps
-            if(3 == generic._scheme.size())
-            {
-                if("ftp"sv == generic._scheme)
-                    return phase2(dst.template emplace<FTP<DstString>>(WWW<DstString>{std::move(generic)}));
-            }
-            else if(4 == generic._scheme.size())
+
+            Summary res = summarize(src);
+
+            std::lock_guard lock{_mtx};
+            if(!_slotsCount || _index.contains(src))
+                return res;
+
+            std::size_t index;
+            if(_size < _slotsCount)
+                index = _size++;
+            else
             {
-                switch(generic._scheme[1])
+                while(_slots[_hand]._referenced)
                 {
-                case 'i':
-                    if("file"sv == generic._scheme)
-                        return phase2(dst.template emplace<File<DstString>>(std::move(generic)));
-                    break;
-                case 't':
-                    if("ftps"sv == generic._scheme)
-                        return phase2(dst.template emplace<FTPS<DstString>>(WWW<DstString>{std::move(generic)}));
-                    break;
+                    _slots[_hand]._referenced = false;
+                    _hand = (_hand + 1) % _slotsCount;
                 }
+
+                index = _hand;
+                _hand = (_hand + 1) % _slotsCount;
+                _index.erase(std::string_view{_slots[index]._src});
             }
-            break;
-        case 'h': //http, https
-            if(4 == generic._scheme.size())
-            {
-                if("http"sv == generic._scheme)
-                    return phase2(dst.template emplace<HTTP<DstString>>(WWW<DstString>{std::move(generic)}));
-            }
-            else if(5 == generic._scheme.size())
-            {
-                if("https"sv == generic._scheme)
-                    return phase2(dst.template emplace<HTTPS<DstString>>(WWW<DstString>{std::move(generic)}));
-            }
-            break;
+
+            Slot& slot = _slots[index];
+            slot._src.assign(src);
+            slot._summary = res;
+            slot._referenced = false;
+            _index.emplace(std::string_view{slot._src}, index);
+
+            return res;
         }
 
-        if(generic._hierPart.starts_with("//"sv))
-            return phase2(dst.template emplace<WWW<DstString>>(std::move(generic)));
+        void setCapacity(std::size_t capacity)
+        {
+            std::lock_guard lock{_mtx};
+
+            _index = {};
+            _index.reserve(capacity);
+            _slots.reset(capacity ? new Slot[capacity] : nullptr);
+            _slotsCount = capacity;
+            _size = 0;
+            _hand = 0;
+            _hits = 0;
+            _misses = 0;
+            _capacity.store(capacity, std::memory_order_relaxed);
+        }
+
+        CacheStats stats()
+        {
+            std::lock_guard lock{_mtx};
+            return CacheStats{_hits, _misses, _size, _slotsCount};
+        }
+
+    private:
+        struct Slot
+        {
+            std::string _src;
+            Summary     _summary;
+            bool        _referenced{};
+        };
+
+        std::atomic<std::size_t>                _capacity{};
+
+        std::mutex                              _mtx;
+        std::unique_ptr<Slot[]>                 _slots;
+        std::size_t                             _slotsCount{};
+        std::size_t                             _size{};
+        std::size_t                             _hand{};
+        FlatMap<std::string_view, std::size_t>  _index;     // ключи ссылаются на Slot::_src
+        std::uint64_t                           _hits{};
+        std::uint64_t                           _misses{};
+    };
+
+    SummaryCache& summaryCache()
+    {
+        static SummaryCache res;
+        return res;
+    }
+}
+
+namespace dci::utils::uri::details
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool API_DCI_UTILS compactLayout(std::string_view src, CompactLayout& dst)
+    {
+        dst = CompactLayout{};
+
+        if(src.size() > std::numeric_limits<std::uint32_t>::max())
+            return false;
+
+        Parsed parsed;
+        bool res = scanUri(src, parsed);
+
+        const char* b = src.data();
+        auto offset = [&](const char* p)
+        {
+            return static_cast<std::uint32_t>(p - b);
+        };
+
+        dst._size = offset(b + src.size());
+        dst._kind = parsed._kind;
+        dst._valid = res;
+
+        if(Kind::unknown == parsed._kind)
+            return false;
+
+        dst._schemeEnd = offset(parsed._scheme._end);
+        dst._hierEnd = offset(parsed._hierPart._end);
+        dst._queryEnd = parsed._query.present() ? offset(parsed._query._end) : dst._hierEnd;
+
+        if(!res)
+            return false;
+
+        dst._hostKind = parsed._hostKind;
+
+        if(Kind::file == parsed._kind)
+        {
+            dst._hostBegin = dst._schemeEnd + 3;
+            dst._hostEnd = parsed._auth.present() ? offset(parsed._auth._end) : dst._hostBegin;
+            dst._pathBegin = offset(parsed._path._begin);
+        }
+        else if(parsed._host.present())
+        {
+            // в смещениях хост - вместе со скобками IP-literal
+            std::uint32_t brackets = (HostKind::ip6 == parsed._hostKind || HostKind::ipFuture == parsed._hostKind) ? 1 : 0;
+            dst._hostBegin = offset(parsed._host._begin) - brackets;
+            dst._hostEnd = offset(parsed._host._end) + brackets;
+
+            if(parsed._userName.present())
+                dst._nameEnd = offset(parsed._userName._end);
+
+            dst._pathBegin = parsed._path.present() ? offset(parsed._path._begin) : dst._hierEnd;
+        }
 
-        dst = std::move(generic);
         return true;
     }
 }
@@ -610,13 +1035,19 @@ namespace dci::utils::uri
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     bool API_DCI_UTILS parse(std::string_view src, URI<std::string_view>& dst)
     {
-        return phase1(src, dst);
+        return parseImpl(src, dst);
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     bool API_DCI_UTILS parse(std::string_view src, URI<std::string>& dst)
     {
-        return phase1(src, dst);
+        return parseImpl(src, dst);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool API_DCI_UTILS parse(std::string_view src, URI<std::pmr::string>& dst, std::pmr::memory_resource* mr)
+    {
+        return parseImpl(src, dst, std::pmr::polymorphic_allocator<char>{mr});
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -626,6 +1057,31 @@ namespace dci::utils::uri
         return parse(src, tmp) && !std::holds_alternative<uri::Unknown<std::string_view>>(tmp);
     }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void API_DCI_UTILS parseBatch(std::span<const std::string_view> srcs, Batch& dst)
+    {
+        dst.resize(srcs.size());
+        parseBatchRange(srcs, dst, 0, srcs.size());
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void API_DCI_UTILS parseBatchParallel(std::span<const std::string_view> srcs, Batch& dst, std::size_t serialThreshold)
+    {
+        if(srcs.size() <= serialThreshold)
+            return parseBatch(srcs, dst);
+
+        dst.resize(srcs.size());
+
+        // строки результата независимы, куски пишут в разные элементы заранее размеченных столбцов
+        constexpr std::size_t chunkSize = 1024;
+
+        workers::parallelFor((srcs.size() + chunkSize - 1) / chunkSize, [&](std::size_t index)
+        {
+            std::size_t begin = index * chunkSize;
+            parseBatchRange(srcs, dst, begin, std::min(begin + chunkSize, srcs.size()));
+        });
+    }
+
     namespace
     {
         /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -662,32 +1118,83 @@ namespace dci::utils::uri
                               }, src);
         }
 
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        // hostPort по частям - чтобы сначала узнать точный размер, а потом писать без промежуточных строк
+        struct HostPort
+        {
+            std::string_view                _host{};
+            bool                            _brackets{};
+            std::optional<std::string_view> _port{};
+
+            std::size_t size() const
+            {
+                return _host.size() + (_brackets ? 2 : 0) + (_port ? 1 + _port->size() : 0);
+            }
+
+            void write(char* out) const
+            {
+                if(_brackets)
+                    *out++ = '[';
+                out = std::copy(_host.begin(), _host.end(), out);
+                if(_brackets)
+                    *out++ = ']';
+
+                if(_port)
+                {
+                    *out++ = ':';
+                    std::copy(_port->begin(), _port->end(), out);
+                }
+            }
+
+            std::size_t write(char* buf, std::size_t bufSize) const
+            {
+                std::size_t res = size();
+                if(res <= bufSize)
+                    write(buf);
+                return res;
+            }
+
+            std::size_t append(std::string& dst) const
+            {
+                std::size_t res = size();
+                std::size_t offset = dst.size();
+                dst.resize(offset + res);
+                write(dst.data() + offset);
+                return res;
+            }
+
+            std::string str() const
+            {
+                std::string res;
+                append(res);
+                return res;
+            }
+        };
+
         /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
         template <class String>
-        std::string hostPortImpl(const URI<String>& src)
+        HostPort hostPortImpl(const URI<String>& src)
         {
-            return std::visit([]<class Alt>(const Alt& alt) -> std::string {
+            auto node = [](const NetworkNode<String>& node)
+            {
+                HostKind kind = static_cast<HostKind>(node._host.index());
+                return HostPort
+                {
+                    std::visit([](const auto& ipOrRegname) -> std::string_view { return ipOrRegname; }, node._host),
+                    HostKind::ip6 == kind || HostKind::ipFuture == kind,
+                    node._port ? std::optional<std::string_view>{*node._port} : std::nullopt,
+                };
+            };
+
+            return std::visit([&]<class Alt>(const Alt& alt) -> HostPort {
                                   if constexpr(std::is_same_v<File<String>, Alt>)
-                                      return alt._auth ? std::string{*alt._auth} : std::string{};
-                                  if constexpr(std::is_same_v<TCP<String>, Alt> || std::is_base_of_v<TCP<String>, Alt>)
-                                      return std::visit([&]<class IpOrRegname>(const IpOrRegname& ipOrRegname) -> std::string  {
-                                          if constexpr(std::is_same_v<networkNode::Ip6<>, IpOrRegname> || std::is_same_v<networkNode::IpFuture<>, IpOrRegname>)
-                                              return std::string{"["} + std::string{ipOrRegname} + "]";
-                                          return std::string{ipOrRegname};
-                                      }, alt._auth._host) + (alt._auth._port ? (":" + std::string{*alt._auth._port}) : std::string{});
-                                  if constexpr(std::is_same_v<UDP<String>, Alt> || std::is_base_of_v<UDP<String>, Alt>)
-                                  return std::visit([&]<class IpOrRegname>(const IpOrRegname& ipOrRegname) -> std::string  {
-                                          if constexpr(std::is_same_v<networkNode::Ip6<>, IpOrRegname> || std::is_same_v<networkNode::IpFuture<>, IpOrRegname>)
-                                              return std::string{"["} + std::string{ipOrRegname} + "]";
-                                          return std::string{ipOrRegname};
-                                      }, alt._auth._host) + (alt._auth._port ? (":" + std::string{*alt._auth._port}) : std::string{});
-                                  if constexpr(std::is_same_v<WWW<String>, Alt> || std::is_base_of_v<WWW<String>, Alt>)
-                                  return std::visit([&]<class IpOrRegname>(const IpOrRegname& ipOrRegname) -> std::string  {
-                                          if constexpr(std::is_same_v<networkNode::Ip6<>, IpOrRegname> || std::is_same_v<networkNode::IpFuture<>, IpOrRegname>)
-                                              return std::string{"["} + std::string{ipOrRegname} + "]";
-                                          return std::string{ipOrRegname};
-                                      }, alt._auth._networkNode._host) + (alt._auth._networkNode._port ? (":" + std::string{*alt._auth._networkNode._port}) : std::string{});
-                                  return {};
+                                      return {alt._auth ? std::string_view{*alt._auth} : ""sv};
+                                  else if constexpr(std::is_base_of_v<TCP<String>, Alt> || std::is_base_of_v<UDP<String>, Alt>)
+                                      return node(alt._auth);
+                                  else if constexpr(std::is_base_of_v<WWW<String>, Alt>)
+                                      return node(alt._auth._networkNode);
+                                  else
+                                      return {};
                               }, src);
         }
     }
@@ -695,10 +1202,7 @@ namespace dci::utils::uri
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string_view API_DCI_UTILS scheme(std::string_view src)
     {
-        URI<> tmp;
-        if(!parse(src, tmp))
-            return {};
-        return schemeImpl(tmp);
+        return summaryCache().get(src)._scheme.of(src);
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -713,13 +1217,16 @@ namespace dci::utils::uri
         return schemeImpl(src);
     }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string_view API_DCI_UTILS scheme(const URI<std::pmr::string>& src)
+    {
+        return schemeImpl(src);
+    }
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string_view API_DCI_UTILS host(std::string_view src)
     {
-        URI<> tmp;
-        if(!parse(src, tmp))
-            return {};
-        return hostImpl(tmp);
+        return summaryCache().get(src)._host.of(src);
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -734,63 +1241,118 @@ namespace dci::utils::uri
         return hostImpl(src);
     }
 
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string_view API_DCI_UTILS host(const URI<std::pmr::string>& src)
+    {
+        return hostImpl(src);
+    }
+
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string API_DCI_UTILS hostPort(std::string_view src)
     {
-        URI<> tmp;
-        if(!parse(src, tmp))
-            return {};
-        return hostPortImpl(tmp);
+        return std::string{summaryCache().get(src)._hostPort.of(src)};
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string API_DCI_UTILS hostPort(const URI<std::string_view>& src)
     {
-        return hostPortImpl(src);
+        return hostPortImpl(src).str();
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     std::string API_DCI_UTILS hostPort(const URI<std::string>& src)
     {
-        return hostPortImpl(src);
+        return hostPortImpl(src).str();
     }
 
-    namespace
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::string API_DCI_UTILS hostPort(const URI<std::pmr::string>& src)
     {
-        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
-        template <class String>
-        bool isCoverImpl(const URI<String>& base, const URI<String>& target)
-        {
-            // inproc < local < ip < regname
+        return hostPortImpl(src).str();
+    }
 
-            if(std::holds_alternative<uri::Inproc<String>>(base))
-                return true;
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(std::string_view src, char* buf, std::size_t bufSize)
+    {
+        return HostPort{summaryCache().get(src)._hostPort.of(src)}.write(buf, bufSize);
+    }
 
-            if(std::holds_alternative<uri::Inproc<String>>(target))
-                return false;
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string_view>& src, char* buf, std::size_t bufSize)
+    {
+        return hostPortImpl(src).write(buf, bufSize);
+    }
 
-            if(std::holds_alternative<uri::Local<String>>(base))
-                return true;
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string>& src, char* buf, std::size_t bufSize)
+    {
+        return hostPortImpl(src).write(buf, bufSize);
+    }
 
-            if(std::holds_alternative<uri::Local<String>>(target))
-                return false;
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::pmr::string>& src, char* buf, std::size_t bufSize)
+    {
+        return hostPortImpl(src).write(buf, bufSize);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(std::string_view src, std::string& dst)
+    {
+        return HostPort{summaryCache().get(src)._hostPort.of(src)}.append(dst);
+    }
 
-            return ip::isCover(hostImpl(base), hostImpl(target));
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string_view>& src, std::string& dst)
+    {
+        return hostPortImpl(src).append(dst);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::string>& src, std::string& dst)
+    {
+        return hostPortImpl(src).append(dst);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    std::size_t API_DCI_UTILS hostPort(const URI<std::pmr::string>& src, std::string& dst)
+    {
+        return hostPortImpl(src).append(dst);
+    }
+
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        template <class String>
+        bool isCoverImpl(const URI<String>& base, const URI<String>& target)
+        {
+            return isCoverSummary(static_cast<Kind>(base.index()), hostImpl(base), static_cast<Kind>(target.index()), hostImpl(target));
         }
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
     bool isCover(std::string_view baseStr, std::string_view targetStr)
     {
-        URI<std::string_view> base;
-        if(!parse(baseStr, base) || std::holds_alternative<uri::Unknown<std::string_view>>(base))
+        Summary base = summaryCache().get(baseStr);
+        if(!base._valid)
             return false;
 
-        URI<std::string_view> target;
-        if(!parse(targetStr, target) || std::holds_alternative<uri::Unknown<std::string_view>>(target))
+        Summary target = summaryCache().get(targetStr);
+        if(!target._valid)
             return false;
 
-        return isCoverImpl(base, target);
+        return isCoverSummary(base._kind, base._host.of(baseStr), target._kind, target._host.of(targetStr));
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void API_DCI_UTILS setCacheCapacity(std::size_t capacity)
+    {
+        summaryCache().setCapacity(capacity);
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    CacheStats API_DCI_UTILS cacheStats()
+    {
+        return summaryCache().stats();
     }
 
     /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
@@ -804,4 +1366,10 @@ namespace dci::utils::uri
     {
         return isCoverImpl(base, target);
     }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    bool API_DCI_UTILS isCover(const URI<std::pmr::string>& base, const URI<std::pmr::string>& target)
+    {
+        return isCoverImpl(base, target);
+    }
 }
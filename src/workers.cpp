@@ -0,0 +1,155 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include "workers.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace dci::utils::workers
+{
+    namespace
+    {
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        struct Job
+        {
+            Job(std::size_t count, const std::function<void(std::size_t)>& f)
+                : _count{count}
+                , _f{f}
+            {
+            }
+
+            // разбирает индексы пока они есть, возвращается сразу как только свободных не осталось
+            void run()
+            {
+                for(;;)
+                {
+                    std::size_t index = _next.fetch_add(1, std::memory_order_relaxed);
+                    if(index >= _count)
+                        return;
+
+                    _f(index);
+
+                    if(_count == _done.fetch_add(1, std::memory_order_acq_rel) + 1)
+                    {
+                        std::lock_guard l{_mtx};
+                        _cv.notify_all();
+                    }
+                }
+            }
+
+            void wait()
+            {
+                std::unique_lock l{_mtx};
+                _cv.wait(l, [&]{ return _count == _done.load(std::memory_order_acquire); });
+            }
+
+            const std::size_t                           _count;
+            const std::function<void(std::size_t)>&     _f;
+            std::atomic<std::size_t>                    _next{};
+            std::atomic<std::size_t>                    _done{};
+            std::mutex                                  _mtx;
+            std::condition_variable                     _cv;
+        };
+
+        using JobPtr = std::shared_ptr<Job>;
+
+        /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+        class Pool
+        {
+        public:
+            Pool()
+            {
+                std::size_t amount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+                _threads.reserve(amount);
+                for(std::size_t i{}; i<amount; ++i)
+                    _threads.emplace_back([this]{ worker(); });
+            }
+
+            ~Pool()
+            {
+                {
+                    std::lock_guard l{_mtx};
+                    _stop = true;
+                }
+                _cv.notify_all();
+
+                for(std::thread& t : _threads)
+                    t.join();
+            }
+
+            void exec(std::size_t count, const std::function<void(std::size_t)>& f)
+            {
+                JobPtr job = std::make_shared<Job>(count, f);
+
+                if(!_threads.empty())
+                {
+                    {
+                        std::lock_guard l{_mtx};
+                        _jobs.push_back(job);
+                    }
+                    _cv.notify_all();
+                }
+
+                job->run();
+                job->wait();
+
+                if(!_threads.empty())
+                {
+                    std::lock_guard l{_mtx};
+                    std::erase(_jobs, job);
+                }
+            }
+
+        private:
+            void worker()
+            {
+                std::unique_lock l{_mtx};
+                for(;;)
+                {
+                    _cv.wait(l, [&]{ return _stop || !_jobs.empty(); });
+                    if(_stop)
+                        return;
+
+                    JobPtr job = _jobs.front();
+                    l.unlock();
+                    job->run();
+                    l.lock();
+
+                    if(!_jobs.empty() && _jobs.front() == job)
+                        _jobs.pop_front();
+                }
+            }
+
+        private:
+            std::mutex                  _mtx;
+            std::condition_variable     _cv;
+            std::deque<JobPtr>          _jobs;
+            bool                        _stop{};
+            std::vector<std::thread>    _threads;
+        };
+    }
+
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& f)
+    {
+        if(count < 2)
+        {
+            for(std::size_t i{}; i<count; ++i)
+                f(i);
+            return;
+        }
+
+        static Pool pool;
+        pool.exec(count, f);
+    }
+}
@@ -0,0 +1,19 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace dci::utils::workers
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // выполняет f(0..count-1) на общем пуле потоков, вызывающий поток участвует в работе. Возврат - после завершения всех f.
+    // Пул создается лениво, по одному потоку на ядро кроме вызывающего
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& f);
+}
@@ -7,7 +7,9 @@
 
 #include <dci/test.hpp>
 #include <dci/utils/b2h.hpp>
+#include <dci/utils/h2b.hpp>
 #include <dci/utils/endian.hpp>
+#include <memory_resource>
 
 using namespace dci::utils;
 
@@ -31,3 +33,198 @@ TEST(utils, b2h)
     b2h(&bin, 4, hex.data(), HexEndian::big);
     EXPECT_EQ(hex, "abcdef00");
 }
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, b2h_sizes)
+{
+    const char* digits = "0123456789abcdef";
+
+    std::vector<std::uint8_t> bin(300);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*37 + 11);
+
+    for(std::size_t size{}; size<=bin.size(); ++size)
+    {
+        std::string little, middle, big;
+        for(std::size_t i{}; i<size; ++i)
+        {
+            little += digits[bin[i]&0xf];
+            little += digits[bin[i]>>4];
+
+            middle += digits[bin[i]>>4];
+            middle += digits[bin[i]&0xf];
+
+            big += digits[bin[size-1-i]>>4];
+            big += digits[bin[size-1-i]&0xf];
+        }
+
+        EXPECT_EQ(b2h(bin.data(), size, HexEndian::little), little);
+        EXPECT_EQ(b2h(bin.data(), size, HexEndian::middle), middle);
+        EXPECT_EQ(b2h(bin.data(), size, HexEndian::big), big);
+
+        // и все остальные ядра, пригодные на этом процессоре, а не только рабочее
+        for(std::size_t variant{}; variant<details::b2hVariants(); ++variant)
+        {
+            std::string hex(size*2, '\0');
+            details::b2hVariant(variant, bin.data(), size, hex.data(), HexEndian::little);
+            EXPECT_EQ(hex, little) << variant;
+            details::b2hVariant(variant, bin.data(), size, hex.data(), HexEndian::middle);
+            EXPECT_EQ(hex, middle) << variant;
+            details::b2hVariant(variant, bin.data(), size, hex.data(), HexEndian::big);
+            EXPECT_EQ(hex, big) << variant;
+        }
+    }
+
+    EXPECT_GE(details::b2hVariants(), 2u);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, b2h_append)
+{
+    std::array<std::uint8_t, 4> id{0x01, 0x23, 0xab, 0xef};
+
+    std::string str = "id=";
+    b2h(id, str, HexEndian::middle);
+    b2h(id.data(), 2, str, HexEndian::big);
+    EXPECT_EQ(str, "id=0123abef2301");
+
+    std::pmr::string pstr{std::pmr::new_delete_resource()};
+    b2h(std::vector<std::uint8_t>(id.begin(), id.end()), pstr);
+    EXPECT_EQ(pstr, "1032bafe");
+
+    std::array<char, 8> fixed;
+    b2h(id, fixed, HexEndian::big);
+    EXPECT_EQ(std::string_view(fixed.data(), fixed.size()), "efab2301");
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, b2h_parallel)
+{
+    std::vector<std::uint8_t> bin(1024*1024 + 12345);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i ^ (i>>8) ^ (i>>16));
+
+    for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+    {
+        std::string hex(bin.size()*2, '\0');
+        b2hParallel(bin.data(), bin.size(), hex.data(), he, 0);
+        EXPECT_EQ(hex, b2h(bin.data(), bin.size(), he));
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, b2h_batch)
+{
+    std::vector<std::uint8_t> bin(64*33);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*31 + 7);
+
+    for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+    {
+        std::vector<B2hBatchItem> items;
+        std::string etalon;
+        for(std::size_t i{}, pos{}; i<40; pos += i, ++i)
+        {
+            items.emplace_back(bin.data()+pos, i);
+            etalon += b2h(bin.data()+pos, i, he);
+        }
+
+        std::vector<std::size_t> offsets;
+        EXPECT_EQ(b2hBatch(items, offsets, he), etalon);
+        ASSERT_EQ(offsets.size(), items.size()+1);
+        for(std::size_t i{}; i<items.size(); ++i)
+            EXPECT_EQ(offsets[i+1]-offsets[i], items[i].second*2);
+        EXPECT_EQ(offsets.back(), etalon.size());
+
+        for(std::size_t stride : {20u, 33u})
+        {
+            etalon.clear();
+            for(std::size_t i{}; i<40; ++i)
+                etalon += b2h(bin.data()+i*stride, 20, he);
+
+            EXPECT_EQ(b2hBatch(bin.data(), 20, stride, 40, he), etalon);
+        }
+
+        // короткие элементы подряд и вперемешку с прочими - для ядер, кодирующих их попарно
+        items.clear();
+        etalon.clear();
+        for(std::size_t i{}, pos{}; i<60; ++i)
+        {
+            std::size_t size = (i%7 == 6) ? i%5 + 32*(i%2) : 16 + (i*5)%16;
+            items.emplace_back(bin.data()+pos, size);
+            etalon += b2h(bin.data()+pos, size, he);
+            pos += size;
+        }
+
+        for(std::size_t variant{}; variant<details::b2hVariants(); ++variant)
+        {
+            std::string hex(etalon.size(), '\0');
+            offsets.assign(items.size()+1, 0);
+            details::b2hBatchVariant(variant, items, hex.data(), offsets.data(), he);
+            EXPECT_EQ(hex, etalon) << variant;
+            for(std::size_t i{}; i<items.size(); ++i)
+                EXPECT_EQ(offsets[i+1]-offsets[i], items[i].second*2) << variant;
+
+            for(std::size_t itemSize : {16u, 20u, 31u})
+            {
+                std::string stridedEtalon;
+                for(std::size_t i{}; i<33; ++i)
+                    stridedEtalon += b2h(bin.data()+i*33, itemSize, he);
+
+                hex.assign(stridedEtalon.size(), '\0');
+                details::b2hBatchVariant(variant, bin.data(), itemSize, 33, 33, hex.data(), he);
+                EXPECT_EQ(hex, stridedEtalon) << variant << ' ' << itemSize;
+            }
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+namespace
+{
+    template <std::size_t N>
+    void checkFixed()
+    {
+        std::array<std::uint8_t, N> bin;
+        for(std::size_t i{}; i<N; ++i)
+            bin[i] = static_cast<std::uint8_t>(i*97 + N);
+
+        for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+        {
+            std::string etalon = b2h(bin.data(), N, he);
+            EXPECT_EQ(b2h(bin, he), etalon);
+
+            std::array<char, N*2> hex;
+            b2h(bin, hex, he);
+            EXPECT_EQ(std::string_view(hex.data(), hex.size()), etalon);
+
+            std::string upper = etalon;
+            for(char& c : upper)
+                c = static_cast<char>(std::toupper(c));
+            std::copy(upper.begin(), upper.end(), hex.begin());
+
+            std::array<std::uint8_t, N> dec{};
+            EXPECT_TRUE(h2b(hex, dec, he));
+            EXPECT_EQ(dec, bin);
+
+            for(char bad : {'/', ':', '@', 'G', '`', 'g', ' ', '\x80', '\xb0', '\xe1'})
+            {
+                std::array<char, N*2> badHex = hex;
+                badHex[(N*7) % (N*2)] = bad;
+                EXPECT_FALSE(h2b(badHex, dec, he));
+            }
+        }
+    }
+}
+
+TEST(utils, b2h_fixed)
+{
+    checkFixed<1>();
+    checkFixed<3>();
+    checkFixed<8>();
+    checkFixed<16>();
+    checkFixed<20>();
+    checkFixed<32>();
+    checkFixed<64>();
+    checkFixed<65>();
+}
@@ -0,0 +1,62 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/base32.hpp>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, base32)
+{
+    const std::pair<const char*, const char*> vectors[] =
+    {
+        {"",        ""},
+        {"f",       "MY======"},
+        {"fo",      "MZXQ===="},
+        {"foo",     "MZXW6==="},
+        {"foob",    "MZXW6YQ="},
+        {"fooba",   "MZXW6YTB"},
+        {"foobar",  "MZXW6YTBOI======"},
+    };
+
+    for(const auto& [bin, txt] : vectors)
+    {
+        EXPECT_EQ(base32::encode(bin, strlen(bin)), txt);
+
+        std::vector<char> dec = base32::decode<char>(txt);
+        EXPECT_EQ(std::string(dec.begin(), dec.end()), bin);
+    }
+
+    EXPECT_EQ(base32::encode("foobar", 6, base32::Alphabet::hex, false), "CPNMUOJ1E8");
+
+    std::vector<std::uint8_t> bin(300);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*167 + 11);
+
+    for(base32::Alphabet a : {base32::Alphabet::standard, base32::Alphabet::hex})
+    {
+        for(bool pad : {true, false})
+        {
+            for(std::size_t size{}; size<=bin.size(); ++size)
+            {
+                std::string txt = base32::encode(bin.data(), size, a, pad);
+                EXPECT_EQ(txt.size(), base32::encodedSize(size, pad));
+
+                std::vector<std::uint8_t> dec;
+                EXPECT_TRUE(base32::decode(txt.data(), txt.size(), dec, a));
+                EXPECT_EQ(dec, std::vector<std::uint8_t>(bin.begin(), bin.begin()+static_cast<std::ptrdiff_t>(size)));
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> dec;
+    EXPECT_TRUE(base32::decode("mzxw6ytb", dec));
+    EXPECT_FALSE(base32::decode("MZX", dec));
+    EXPECT_FALSE(base32::decode("MZXW6===X", dec));
+    EXPECT_FALSE(base32::decode("MZXW61==", dec));
+}
@@ -0,0 +1,110 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/base64.hpp>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, base64_rfc4648)
+{
+    const std::pair<const char*, const char*> vectors[] =
+    {
+        {"",        ""},
+        {"f",       "Zg=="},
+        {"fo",      "Zm8="},
+        {"foo",     "Zm9v"},
+        {"foob",    "Zm9vYg=="},
+        {"fooba",   "Zm9vYmE="},
+        {"foobar",  "Zm9vYmFy"},
+    };
+
+    for(const auto& [bin, txt] : vectors)
+    {
+        EXPECT_EQ(base64::encode(bin, strlen(bin)), txt);
+
+        std::vector<char> dec = base64::decode<char>(txt);
+        EXPECT_EQ(std::string(dec.begin(), dec.end()), bin);
+
+        std::string unpadded{txt};
+        while(!unpadded.empty() && '=' == unpadded.back())
+            unpadded.pop_back();
+        EXPECT_EQ(base64::encode(bin, strlen(bin), base64::Alphabet::standard, false), unpadded);
+        dec = base64::decode<char>(unpadded.c_str());
+        EXPECT_EQ(std::string(dec.begin(), dec.end()), bin);
+    }
+
+    std::uint8_t bin[] = {0xfb, 0xff, 0xbf};
+    EXPECT_EQ(base64::encode(bin, 3), "+/+/");
+    EXPECT_EQ(base64::encode(bin, 3, base64::Alphabet::url), "-_-_");
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, base64_roundtrip)
+{
+    std::vector<std::uint8_t> bin(300);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*167 + 11);
+
+    for(base64::Alphabet a : {base64::Alphabet::standard, base64::Alphabet::url})
+    {
+        for(bool pad : {true, false})
+        {
+            for(std::size_t size{}; size<=bin.size(); ++size)
+            {
+                std::string txt = base64::encode(bin.data(), size, a, pad);
+                EXPECT_EQ(txt.size(), base64::encodedSize(size, pad));
+
+                std::vector<std::uint8_t> dec;
+                EXPECT_TRUE(base64::decode(txt.data(), txt.size(), dec, a));
+                EXPECT_EQ(dec, std::vector<std::uint8_t>(bin.begin(), bin.begin()+static_cast<std::ptrdiff_t>(size)));
+
+                // и все остальные ядра, пригодные на этом процессоре, а не только рабочее
+                for(std::size_t variant{}; variant<base64::details::variants(); ++variant)
+                {
+                    std::string vtxt(txt.size(), '\0');
+                    base64::details::encodeVariant(variant, bin.data(), size, vtxt.data(), a, pad);
+                    EXPECT_EQ(vtxt, txt) << variant;
+
+                    std::vector<std::uint8_t> vdec(base64::decodedSize(txt.size()));
+                    std::size_t bsize{};
+                    EXPECT_TRUE(base64::details::decodeVariant(variant, txt.data(), txt.size(), vdec.data(), bsize, a)) << variant;
+                    vdec.resize(bsize);
+                    EXPECT_EQ(vdec, dec) << variant;
+                }
+            }
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, base64_bad)
+{
+    std::vector<std::uint8_t> dec;
+    EXPECT_FALSE(base64::decode("Z", dec));
+    EXPECT_FALSE(base64::decode("Zg=", dec));
+    EXPECT_FALSE(base64::decode("Z===", dec));
+    EXPECT_FALSE(base64::decode("Zm9v-_", dec));
+    EXPECT_FALSE(base64::decode("Zm9v+/", dec, base64::Alphabet::url));
+    EXPECT_TRUE(dec.empty());
+
+    std::string txt = base64::encode(std::vector<std::uint8_t>(200, 0x5a));
+    for(std::size_t pos : {0u, 17u, 31u, 100u, 250u, 266u})
+    {
+        std::string bad = txt;
+        bad[pos] = '*';
+        EXPECT_FALSE(base64::decode(bad.data(), bad.size(), dec));
+
+        std::vector<std::uint8_t> vdec(base64::decodedSize(bad.size()));
+        for(std::size_t variant{}; variant<base64::details::variants(); ++variant)
+        {
+            std::size_t bsize{};
+            EXPECT_FALSE(base64::details::decodeVariant(variant, bad.data(), bad.size(), vdec.data(), bsize, base64::Alphabet::standard)) << variant;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace dci::utils::bench
+{
+    /////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+    // для DISABLED_*_bench: среднее время вызова f(r), r = 0..rounds-1, в наносекундах.
+    // Результаты f суммируются и сохраняются в volatile, чтобы вычисления не были выброшены
+    template <class F>
+    double measure(std::size_t rounds, F&& f)
+    {
+        std::uint64_t sink{};
+
+        auto start = std::chrono::steady_clock::now();
+        for(std::size_t r{}; r<rounds; ++r)
+            sink += static_cast<std::uint64_t>(f(r));
+        auto stop = std::chrono::steady_clock::now();
+
+        volatile std::uint64_t keep = sink;
+        (void)keep;
+
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(rounds);
+    }
+}
@@ -0,0 +1,129 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/crc32c.hpp>
+#include <dci/utils/fnv1a.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench.hpp"
+#include <iostream>
+
+using namespace dci::utils;
+
+namespace
+{
+    std::uint32_t crc32cBitwise(const std::uint8_t* data, std::size_t size)
+    {
+        std::uint32_t crc = ~0u;
+        for(std::size_t i{}; i<size; ++i)
+        {
+            crc ^= data[i];
+            for(int k{}; k<8; ++k)
+                crc = (crc >> 1) ^ (crc & 1 ? 0x82f63b78 : 0);
+        }
+        return ~crc;
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, crc32c)
+{
+    EXPECT_EQ(crc32c("", 0), 0u);
+    EXPECT_EQ(crc32c(std::string_view{"123456789"}), 0xe3069283u);
+
+    // RFC 3720, B.4
+    std::vector<std::uint8_t> v(32, 0x00);
+    EXPECT_EQ(crc32c(v), 0x8a9136aau);
+
+    v.assign(32, 0xff);
+    EXPECT_EQ(crc32c(v), 0x62a8ab43u);
+
+    for(std::size_t i{}; i<32; ++i)
+        v[i] = static_cast<std::uint8_t>(i);
+    EXPECT_EQ(crc32c(v), 0x46dd794eu);
+
+    for(std::size_t i{}; i<32; ++i)
+        v[i] = static_cast<std::uint8_t>(31-i);
+    EXPECT_EQ(crc32c(v), 0x113fdb5cu);
+
+    // все ветви ядра (блоки по 3*1024, 3*128, по 8 байт, хвост), с невыровненного начала
+    std::vector<std::uint8_t> material(12000);
+    for(std::size_t i{}; i<material.size(); ++i)
+        material[i] = static_cast<std::uint8_t>(i*167 + 11 + (i>>9));
+
+    for(std::size_t size{}; size<material.size(); size += (size < 500 ? 1 : 97))
+    {
+        std::uint32_t etalon = crc32cBitwise(material.data()+1, size);
+        EXPECT_EQ(crc32c(material.data()+1, size), etalon);
+
+        // и все остальные ядра, пригодные на этом процессоре, а не только рабочее
+        for(std::size_t variant{}; variant<details::crc32cVariants(); ++variant)
+        {
+            EXPECT_EQ(details::crc32cVariant(variant, material.data()+1, size), etalon) << variant;
+
+            std::size_t split = size/3;
+            EXPECT_EQ(details::crc32cVariant(variant, material.data()+1+split, size-split,
+                                             details::crc32cVariant(variant, material.data()+1, split)), etalon) << variant;
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, crc32c_incremental)
+{
+    std::string material(5000, ' ');
+    for(std::size_t i{}; i<material.size(); ++i)
+        material[i] = static_cast<char>(i*131 + (i>>7));
+
+    std::uint32_t etalon = crc32c(material);
+
+    for(std::size_t split1{}; split1<=material.size(); split1 += 61)
+    {
+        for(std::size_t split2{split1}; split2<=material.size(); split2 += 413)
+        {
+            Crc32c hasher;
+            hasher.update(material.data(), split1);
+            hasher.update(std::string_view{material}.substr(split1, split2-split1));
+            hasher.update(material.data()+split2, material.size()-split2);
+            EXPECT_EQ(hasher.digest(), etalon);
+
+            EXPECT_EQ(crc32c(material.data()+split1, material.size()-split1, crc32c(material.data(), split1)), etalon);
+        }
+    }
+
+    Crc32c hasher;
+    hasher.update(material);
+    hasher.reset();
+    EXPECT_EQ(hasher.digest(), 0u);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, DISABLED_crc32c_bench)
+{
+    std::string material(1024*1024, 'x');
+    for(std::size_t i{}; i<material.size(); ++i)
+        material[i] = static_cast<char>(i*131 + (i>>7));
+
+    auto measure = [&](std::size_t len, auto&& hash)
+    {
+        std::size_t rounds = std::max<std::size_t>(1, (256u<<20) / std::max<std::size_t>(len, 16));
+        return bench::measure(rounds, [&](std::size_t r){return hash(material.data() + (r*8) % (material.size() - len + 1), len);});
+    };
+
+    for(std::size_t len : {16u, 64u, 256u, 1024u, 4096u, 65536u, 1024u*1024u})
+    {
+        double fnv = measure(len, [](const char* p, std::size_t n){return fnv1a(p, n);});
+        double crc = measure(len, [](const char* p, std::size_t n){return crc32c(p, n);});
+
+        std::cout << "len " << len
+                  << ": fnv1a " << fnv << " ns (" << static_cast<double>(len) / fnv << " GB/s)"
+                  << ", crc32c " << crc << " ns (" << static_cast<double>(len) / crc << " GB/s)"
+                  << ", x" << fnv / crc << std::endl;
+    }
+}
@@ -0,0 +1,292 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/flatHash.hpp>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <random>
+#include <memory_resource>
+#include <set>
+#include "bench.hpp"
+#include <iostream>
+
+using namespace dci::utils;
+using namespace std::string_view_literals;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, flatMap)
+{
+    FlatMap<std::string, int> m{{"tcp", 1}, {"udp", 2}};
+    EXPECT_EQ(m.size(), 2u);
+
+    // поиск без временной std::string
+    EXPECT_EQ(m.find("tcp"sv)->second, 1);
+    EXPECT_TRUE(m.contains("udp"));
+    EXPECT_FALSE(m.contains(std::string{"http"}));
+    EXPECT_EQ(m.find("http"sv), m.end());
+
+    m["http"sv] = 3;
+    EXPECT_EQ(m.at("http"), 3);
+    EXPECT_THROW(m.at("https"sv), std::out_of_range);
+
+    EXPECT_FALSE(m.try_emplace("tcp"sv, 10).second);
+    EXPECT_EQ(m["tcp"], 1);
+    EXPECT_FALSE(m.insert_or_assign("tcp"sv, 10).second);
+    EXPECT_EQ(m["tcp"], 10);
+    EXPECT_TRUE(m.emplace("ftp", 4).second);
+
+    EXPECT_EQ(m.erase("udp"sv), 1u);
+    EXPECT_EQ(m.erase("udp"sv), 0u);
+    EXPECT_EQ(m.size(), 3u);
+
+    int sum{};
+    for(const auto& [k, v] : m)
+        sum += v;
+    EXPECT_EQ(sum, 10+3+4);
+
+    FlatMap<std::string, int> copy = m;
+    FlatMap<std::string, int> moved = std::move(m);
+    EXPECT_EQ(copy.size(), 3u);
+    EXPECT_EQ(moved.size(), 3u);
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains("tcp"));
+    m = copy;
+    EXPECT_EQ(m.at("ftp"), 4);
+
+    for(auto iter = m.begin(); iter != m.end(); )
+        iter = iter->second > 3 ? m.erase(iter) : std::next(iter);
+    EXPECT_EQ(m.size(), 1u);
+    EXPECT_EQ(m.at("http"), 3);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+
+    // непереносимые копированием значения, целые ключи разных типов
+    FlatMap<long, std::unique_ptr<int>> u;
+    for(int i{}; i<1000; ++i)
+        u.try_emplace(i, std::make_unique<int>(i));
+    for(int i{}; i<1000; ++i)
+        EXPECT_EQ(*u.at(i), i);
+    EXPECT_FALSE(u.contains(1000));
+
+    // нестроковые ключи другого типа приводятся к key_type, а не сравниваются через std::equal_to<>
+    FlatMap<unsigned, int> mixed;
+    mixed[0xFFFFFFFFu] = 1;
+    EXPECT_TRUE(mixed.contains(-1));
+    mixed[-1] = 2;
+    EXPECT_EQ(mixed.size(), 1u);
+    EXPECT_EQ(mixed.at(0xFFFFFFFFu), 2);
+    EXPECT_FALSE(mixed.try_emplace(-1, 3).second);
+    EXPECT_EQ(mixed.erase(-1), 1u);
+    EXPECT_TRUE(mixed.empty());
+
+    FlatMap<float, int> f;
+    f[0.5f] = 1;
+    f[0.5] = 2;
+    EXPECT_EQ(f.size(), 1u);
+    EXPECT_EQ(f.at(0.5), 2);
+
+    FlatMap<double, int> d;
+    d[1.0] = 1;
+    d[1] = 2;
+    EXPECT_EQ(d.size(), 1u);
+    EXPECT_TRUE(d.contains(1.0f));
+    EXPECT_EQ(d.find(1)->second, 2);
+
+    FlatSet<long> ls{1, 2, 3};
+    EXPECT_TRUE(ls.contains(2u));
+    EXPECT_EQ(ls.count(-1), 0u);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, flatMap_vsStd)
+{
+    // случайные вставки/удаления, включая много удаленных слотов и перестроения
+    std::mt19937_64 rnd{42};
+    FlatMap<std::uint64_t, std::uint64_t> m;
+    std::unordered_map<std::uint64_t, std::uint64_t> etalon;
+
+    for(std::size_t i{}; i<200000; ++i)
+    {
+        std::uint64_t key = rnd() % 5000;
+        switch(rnd() % 4)
+        {
+        case 0:
+        case 1:
+            EXPECT_EQ(m.insert({key, i}).second, etalon.insert({key, i}).second);
+            break;
+        case 2:
+            EXPECT_EQ(m.erase(key), etalon.erase(key));
+            break;
+        case 3:
+            EXPECT_EQ(m.contains(key), etalon.contains(key));
+            if(m.contains(key))
+            {
+                EXPECT_EQ(m.at(key), etalon.at(key));
+            }
+            break;
+        }
+
+        ASSERT_EQ(m.size(), etalon.size());
+        if(0 == i % 50000)
+            m.rehash(0);
+    }
+
+    std::size_t amount{};
+    for(const auto& [k, v] : m)
+    {
+        EXPECT_EQ(etalon.at(k), v);
+        ++amount;
+    }
+    EXPECT_EQ(amount, etalon.size());
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, flatSet)
+{
+    FlatSet<std::string> s;
+    s.reserve(100);
+    std::size_t capacity = s.capacity();
+    EXPECT_GE(static_cast<float>(capacity) * s.max_load_factor(), 100.0f);
+
+    for(int i{}; i<100; ++i)
+        EXPECT_TRUE(s.insert(std::to_string(i)).second);
+    EXPECT_EQ(s.capacity(), capacity);
+    EXPECT_FALSE(s.insert("42").second);
+
+    EXPECT_EQ(s.count("42"sv), 1u);
+    EXPECT_EQ(s.count("100"sv), 0u);
+    EXPECT_EQ(*s.find("7"), "7");
+
+    s.erase(s.find("7"));
+    EXPECT_FALSE(s.contains("7"));
+    EXPECT_EQ(s.size(), 99u);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+namespace
+{
+    // помнит свои блоки, освобождение чужого блока считается ошибкой
+    class TrackingResource
+        : public std::pmr::memory_resource
+    {
+    public:
+        std::set<void*> _blocks;
+        std::size_t     _foreign{};
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            _blocks.insert(p);
+            return p;
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            if(!_blocks.erase(p))
+                ++_foreign;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST(utils, flatMap_pmr)
+{
+    using Map = FlatMap<std::pmr::string, int, FlatHash, std::equal_to<>, std::pmr::polymorphic_allocator<std::pair<std::pmr::string, int>>>;
+
+    TrackingResource ra, rb;
+    {
+        Map a{0, {}, {}, &ra};
+        Map b{0, {}, {}, &rb};
+        for(int i{}; i<100; ++i)
+        {
+            a.try_emplace("a-key-long-enough-to-allocate-" + std::to_string(i), i);
+            b.try_emplace("b-key-long-enough-to-allocate-" + std::to_string(i), i);
+        }
+
+        // копия и перенос между разными ресурсами не меняют ресурс приемника
+        a = b;
+        EXPECT_EQ(a.get_allocator().resource(), &ra);
+        EXPECT_EQ(a.size(), 100u);
+        EXPECT_EQ(a.at("b-key-long-enough-to-allocate-7"), 7);
+        for(const auto& [k, v] : a)
+            EXPECT_EQ(k.get_allocator().resource(), &ra);
+
+        Map c{0, {}, {}, &rb};
+        c.try_emplace("c-key-long-enough-to-allocate", 1);
+        a = std::move(c);
+        EXPECT_EQ(a.get_allocator().resource(), &ra);
+        EXPECT_EQ(a.size(), 1u);
+        EXPECT_EQ(a.at("c-key-long-enough-to-allocate"), 1);
+        EXPECT_EQ(a.begin()->first.get_allocator().resource(), &ra);
+        EXPECT_TRUE(c.empty());
+
+        // при одинаковом ресурсе перенос забирает буферы целиком
+        Map d{0, {}, {}, &ra};
+        d = std::move(a);
+        EXPECT_EQ(d.size(), 1u);
+        EXPECT_TRUE(a.empty());
+
+        b = d;
+        EXPECT_EQ(b.get_allocator().resource(), &rb);
+        EXPECT_EQ(b.size(), 1u);
+    }
+
+    EXPECT_EQ(ra._foreign, 0u);
+    EXPECT_EQ(rb._foreign, 0u);
+    EXPECT_TRUE(ra._blocks.empty());
+    EXPECT_TRUE(rb._blocks.empty());
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, DISABLED_flatMap_bench)
+{
+    for(std::size_t amount : {100u, 10000u, 1000000u})
+    {
+        std::vector<std::string> keys;
+        for(std::size_t i{}; i<amount; ++i)
+            keys.push_back("host-" + std::to_string(i * 2654435761u) + ".example.com");
+
+        std::vector<std::string_view> hits(keys.begin(), keys.end());
+        std::shuffle(hits.begin(), hits.end(), std::mt19937_64{1});
+        std::vector<std::string> misses;
+        for(std::size_t i{}; i<amount; ++i)
+            misses.push_back("miss-" + std::to_string(i));
+
+        std::size_t rounds = std::max<std::size_t>(1, 4000000 / amount);
+
+        std::unordered_map<std::string, std::size_t> um;
+        FlatMap<std::string, std::size_t> fm;
+
+        double umInsert = bench::measure(1, [&](std::size_t){ for(std::size_t i{}; i<amount; ++i) um.emplace(keys[i], i); return um.size(); });
+        double fmInsert = bench::measure(1, [&](std::size_t){ for(std::size_t i{}; i<amount; ++i) fm.try_emplace(keys[i], i); return fm.size(); });
+
+        // у std::unordered_map<std::string> без прозрачного хеша поиск по string_view требует временную строку
+        double umHit = bench::measure(rounds, [&](std::size_t){ std::size_t s{}; for(std::string_view k : hits) s += um.find(std::string{k})->second; return s; });
+        double fmHit = bench::measure(rounds, [&](std::size_t){ std::size_t s{}; for(std::string_view k : hits) s += fm.find(k)->second; return s; });
+
+        double umMiss = bench::measure(rounds, [&](std::size_t){ std::size_t s{}; for(const std::string& k : misses) s += um.count(k); return s; });
+        double fmMiss = bench::measure(rounds, [&](std::size_t){ std::size_t s{}; for(const std::string& k : misses) s += fm.count(k); return s; });
+
+        double lookups = static_cast<double>(amount);
+        std::cout << "amount " << amount
+                  << ": insert unordered_map " << umInsert / 1e6 << " ms, FlatMap " << fmInsert / 1e6 << " ms"
+                  << "; hit " << umHit / lookups << " / " << fmHit / lookups << " ns"
+                  << "; miss " << umMiss / lookups << " / " << fmMiss / lookups << " ns" << std::endl;
+    }
+}
@@ -0,0 +1,84 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/fnv1a.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, fnv1a_incremental)
+{
+    static_assert(fnv1a("") == 0xcbf29ce484222325);
+    static_assert(fnv1a("a") == 0xaf63dc4c8601ec8c);
+    static_assert(fnv1a("foobar") == 0x85944171f73967e8);
+    static_assert(Fnv1a{}.update("foo", 3).update("bar", 3).digest() == fnv1a("foobar"));
+
+    std::string material = "header: value\r\n\r\nsome body \xff\x80 bytes";
+    std::uint64_t etalon = fnv1a(material);
+
+    for(std::size_t split1{}; split1<=material.size(); ++split1)
+    {
+        for(std::size_t split2{split1}; split2<=material.size(); split2 += 7)
+        {
+            Fnv1a hasher;
+            hasher.update(material.data(), split1);
+            hasher.update(std::string_view{material}.substr(split1, split2-split1));
+            hasher.update(material.data()+split2, material.size()-split2);
+            EXPECT_EQ(hasher.digest(), etalon);
+        }
+    }
+
+    std::vector<std::string_view> parts{"header: value\r\n", "", "\r\nsome body ", "\xff\x80 bytes"};
+    EXPECT_EQ(fnv1a(parts), etalon);
+    EXPECT_EQ(fnv1a(std::list<std::string>(parts.begin(), parts.end())), etalon);
+
+    Fnv1a hasher;
+    hasher.update(material);
+    hasher.reset();
+    EXPECT_EQ(hasher.digest(), fnv1a(""));
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, fnv1a_batch)
+{
+    std::vector<std::string> storage;
+    for(std::size_t i{}; i<77; ++i)
+    {
+        std::string key;
+        for(std::size_t j{}; j<(i*13)%41; ++j)
+            key += static_cast<char>(i*31 + j*7 + 0x70);
+        storage.push_back(key);
+    }
+
+    std::vector<std::string_view> keys(storage.begin(), storage.end());
+    for(std::size_t count : {0u, 1u, 3u, 4u, 5u, 8u, 9u, 16u, 77u})
+    {
+        std::vector<std::uint64_t> digests(count);
+        fnv1aBatch(std::span{keys.data(), count}, digests.data());
+
+        for(std::size_t i{}; i<count; ++i)
+            EXPECT_EQ(digests[i], fnv1a(keys[i]));
+
+        // и все остальные ядра, пригодные на этом процессоре, а не только рабочее
+        for(std::size_t variant{}; variant<details::fnv1aBatchVariants(); ++variant)
+        {
+            std::vector<std::uint64_t> vdigests(count);
+            details::fnv1aBatchVariant(variant, std::span{keys.data(), count}, vdigests.data());
+            EXPECT_EQ(vdigests, digests) << variant;
+        }
+    }
+
+    std::array<std::string_view, 4> array{"http", "https", "ws", ""};
+    std::array<std::uint64_t, 4> digests = fnv1aBatch(array);
+    for(std::size_t i{}; i<array.size(); ++i)
+        EXPECT_EQ(digests[i], fnv1a(array[i]));
+}
@@ -25,3 +25,210 @@ TEST(utils, h2b)
     EXPECT_TRUE(h2b("abcdef00", 8, &bin, HexEndian::big));
     EXPECT_EQ(endian::l2n(bin), std::uint32_t{0xabcdef00});
 }
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, h2b_sizes)
+{
+    const char* digits = "0123456789abcdefABCDEF";
+
+    std::string hex(301, '0');
+    for(std::size_t i{}; i<hex.size(); ++i)
+        hex[i] = digits[(i*7 + 3) % 22];
+
+    auto val = [](char c) -> std::uint8_t
+    {
+        if(c <= '9') return static_cast<std::uint8_t>(c - '0');
+        if(c <= 'F') return static_cast<std::uint8_t>(c - 'A' + 10);
+        return static_cast<std::uint8_t>(c - 'a' + 10);
+    };
+
+    for(std::size_t size{}; size<=hex.size(); ++size)
+    {
+        std::size_t bsize = (size+1)/2;
+        std::vector<std::uint8_t> little(bsize), middle(bsize), big(bsize);
+        for(std::size_t i{}; i<size/2; ++i)
+        {
+            little[i] = static_cast<std::uint8_t>(val(hex[i*2]) | (val(hex[i*2+1]) << 4));
+            middle[i] = static_cast<std::uint8_t>((val(hex[i*2]) << 4) | val(hex[i*2+1]));
+        }
+        if(size & 1)
+        {
+            little.back() = val(hex[size-1]);
+            middle.back() = static_cast<std::uint8_t>(val(hex[size-1]) << 4);
+        }
+        {
+            std::size_t hsize = size;
+            std::size_t bi{};
+            if(hsize & 1)
+                big[bi++] = val(hex[--hsize]);
+            for(; hsize; hsize -= 2)
+                big[bi++] = static_cast<std::uint8_t>((val(hex[hsize-2]) << 4) | val(hex[hsize-1]));
+        }
+
+        std::vector<std::uint8_t> bin(bsize);
+        EXPECT_TRUE(h2b(hex.data(), size, bin.data(), HexEndian::little));
+        EXPECT_EQ(bin, little);
+        EXPECT_TRUE(h2b(hex.data(), size, bin.data(), HexEndian::middle));
+        EXPECT_EQ(bin, middle);
+        EXPECT_TRUE(h2b(hex.data(), size, bin.data(), HexEndian::big));
+        EXPECT_EQ(bin, big);
+
+        // и все остальные ядра, пригодные на этом процессоре, а не только рабочее
+        for(std::size_t variant{}; variant<details::h2bVariants(); ++variant)
+        {
+            std::size_t badOffset{};
+            EXPECT_TRUE(details::h2bVariant(variant, hex.data(), size, bin.data(), badOffset, HexEndian::little));
+            EXPECT_EQ(bin, little) << variant;
+            EXPECT_TRUE(details::h2bVariant(variant, hex.data(), size, bin.data(), badOffset, HexEndian::middle));
+            EXPECT_EQ(bin, middle) << variant;
+            EXPECT_TRUE(details::h2bVariant(variant, hex.data(), size, bin.data(), badOffset, HexEndian::big));
+            EXPECT_EQ(bin, big) << variant;
+        }
+    }
+
+    EXPECT_GE(details::h2bVariants(), 1u);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, h2b_badOffset)
+{
+    std::vector<std::uint8_t> bin(100);
+
+    for(std::size_t size{1}; size<=150; size += 7)
+    {
+        for(std::size_t pos{}; pos<size; ++pos)
+        {
+            std::string hex(size, 'a');
+            hex[pos] = 'g';
+            if(pos+3 < size)
+                hex[pos+3] = '/';
+
+            for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+            {
+                std::size_t badOffset{};
+                EXPECT_FALSE(h2b(hex.data(), size, bin.data(), badOffset, he));
+                EXPECT_EQ(badOffset, pos);
+
+                for(std::size_t variant{}; variant<details::h2bVariants(); ++variant)
+                {
+                    EXPECT_FALSE(details::h2bVariant(variant, hex.data(), size, bin.data(), badOffset, he));
+                    EXPECT_EQ(badOffset, pos) << variant;
+                }
+            }
+        }
+
+        std::size_t badOffset{};
+        EXPECT_TRUE(h2b(std::string(size, 'F').data(), size, bin.data(), badOffset));
+        EXPECT_EQ(badOffset, size);
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, h2b_static)
+{
+    using namespace dci::utils::literals;
+
+    constexpr auto magic = "deadBEEF"_hex;
+    static_assert(std::is_same_v<decltype(magic), const std::array<std::uint8_t, 4>>);
+    static_assert(magic == std::array<std::uint8_t, 4>{0xde, 0xad, 0xbe, 0xef});
+    static_assert("abc"_hex == std::array<std::uint8_t, 2>{0xab, 0xc0});
+    static_assert(""_hex.empty());
+
+    static_assert(h2bStatic("abcdef00", HexEndian::little) == std::array<std::uint8_t, 4>{0xba, 0xdc, 0xfe, 0x00});
+    static_assert(h2bStatic("abcdef00", HexEndian::big) == std::array<std::uint8_t, 4>{0x00, 0xef, 0xcd, 0xab});
+    static_assert(h2bStatic("abc", HexEndian::big) == std::array<std::uint8_t, 2>{0x0c, 0xab});
+
+    for(const char* hex : {"0", "a1", "f0e", "0123456789abcdefABCDEF", "x", "12g4"})
+    {
+        std::size_t hsize = strlen(hex);
+        for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+        {
+            std::vector<std::uint8_t> runtime(hsize/2+1), compile(hsize/2+1);
+            bool runtimeRes = h2b(hex, hsize, runtime.data(), he);
+            EXPECT_EQ(runtimeRes, h2bConstexpr(hex, hsize, compile.data(), he));
+            if(runtimeRes)
+            {
+                EXPECT_EQ(runtime, compile);
+            }
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, h2b_parallel)
+{
+    const char* digits = "0123456789abcdefABCDEF";
+
+    std::string hex(2*1024*1024 + 12345, '0');
+    for(std::size_t i{}; i<hex.size(); ++i)
+        hex[i] = digits[(i ^ (i>>7)) % 22];
+
+    for(std::size_t hsize : {hex.size(), hex.size()-1})
+    {
+        for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+        {
+            std::vector<std::uint8_t> bin((hsize+1)/2);
+            EXPECT_TRUE(h2bParallel(hex.data(), hsize, bin.data(), he, 0));
+            EXPECT_EQ(bin, h2b(hex.data(), hsize, he));
+        }
+    }
+
+    std::vector<std::uint8_t> bin(hex.size());
+    hex[hex.size()/3] = 'z';
+    EXPECT_FALSE(h2bParallel(hex.data(), hex.size(), bin.data(), HexEndian::big, 0));
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, h2b_separated)
+{
+    using Bytes = std::vector<std::uint8_t>;
+    Bytes b;
+
+    EXPECT_TRUE(h2bSeparated("de:ad:be:ef", b, HexEndian::middle));
+    EXPECT_EQ(b, (Bytes{0xde, 0xad, 0xbe, 0xef}));
+
+    EXPECT_TRUE(h2bSeparated("0xDEADBEEF", b, HexEndian::middle));
+    EXPECT_EQ(b, (Bytes{0xde, 0xad, 0xbe, 0xef}));
+
+    EXPECT_TRUE(h2bSeparated("0xde, 0Xad,\n\t0xbe 0xef\r\n", b, HexEndian::middle));
+    EXPECT_EQ(b, (Bytes{0xde, 0xad, 0xbe, 0xef}));
+
+    EXPECT_TRUE(h2bSeparated("dead beef", b, HexEndian::big));
+    EXPECT_EQ(b, (Bytes{0xef, 0xbe, 0xad, 0xde}));
+
+    EXPECT_TRUE(h2bSeparated(" ", b));
+    EXPECT_TRUE(b.empty());
+
+    EXPECT_FALSE(h2bSeparated("de:ad", b, HexEndian::middle, " "));
+    EXPECT_FALSE(h2bSeparated("0xdead", b, HexEndian::middle, h2bSeparators, false));
+    EXPECT_FALSE(h2bSeparated("de0xad", b));
+    EXPECT_FALSE(h2bSeparated("0x0xde", b));
+    EXPECT_FALSE(h2bSeparated("de ag", b));
+    EXPECT_TRUE(b.empty());
+
+    // длинный вход с разделителями против h2b над очищенной строкой
+    std::string dirty, clean;
+    for(std::size_t i{}; i<2000; ++i)
+    {
+        char c = "0123456789abcdefABCDEF"[(i*7) % 22];
+        dirty += c;
+        clean += c;
+        if(0 == i%17) dirty += " ";
+        if(0 == i%131) dirty += "\n";
+        if(0 == i%5 && i%17) dirty += ":";
+    }
+
+    for(std::size_t size : {clean.size(), clean.size()-1})
+    {
+        std::string d = dirty;
+        std::string c = clean.substr(0, size);
+        if(size != clean.size())
+            d.resize(d.find_last_of(clean.back()));
+
+        for(HexEndian he : {HexEndian::little, HexEndian::middle, HexEndian::big})
+        {
+            EXPECT_TRUE(h2bSeparated(d, b, he));
+            EXPECT_EQ(b, h2b(c.data(), c.size(), he));
+        }
+    }
+}
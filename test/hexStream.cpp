@@ -0,0 +1,115 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/hexStream.hpp>
+#include <dci/utils/b2h.hpp>
+#include <dci/utils/h2b.hpp>
+#include <stdexcept>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexStream_encoder)
+{
+    std::vector<std::uint8_t> bin(257);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*13 + 5);
+
+    for(HexEndian he : {HexEndian::little, HexEndian::middle})
+    {
+        for(std::size_t chunk : {1u, 3u, 16u, 100u})
+        {
+            HexEncoder encoder{he};
+            std::string hex;
+            for(std::size_t pos{}; pos<bin.size(); pos += chunk)
+            {
+                std::size_t size = std::min(chunk, bin.size()-pos);
+                std::size_t hsize = hex.size();
+                hex.resize(hsize + HexEncoder::outputSize(size));
+                EXPECT_EQ(encoder.update(bin.data()+pos, size, hex.data()+hsize), size*2);
+            }
+
+            EXPECT_EQ(hex, b2h(bin.data(), bin.size(), he));
+            EXPECT_EQ(encoder.consumed(), bin.size());
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexStream_decoder)
+{
+    std::string hex = "0123456789abcdefABCDEF";
+    while(hex.size() < 300)
+        hex += hex;
+    hex.resize(301);
+
+    for(HexEndian he : {HexEndian::little, HexEndian::middle})
+    {
+        std::vector<std::uint8_t> etalon = h2b(hex.data(), hex.size(), he);
+
+        for(std::size_t chunk : {1u, 2u, 3u, 7u, 33u, 500u})
+        {
+            HexDecoder decoder{he};
+            std::vector<std::uint8_t> bin;
+            for(std::size_t pos{}; pos<hex.size(); pos += chunk)
+            {
+                std::size_t size = std::min(chunk, hex.size()-pos);
+                std::size_t bsize = bin.size();
+                bin.resize(bsize + decoder.outputSize(size));
+
+                std::size_t written;
+                EXPECT_TRUE(decoder.update(hex.data()+pos, size, bin.data()+bsize, written));
+                EXPECT_EQ(bsize + written, bin.size());
+            }
+
+            EXPECT_TRUE(decoder.pending());
+            bin.resize(bin.size()+1);
+            std::size_t written;
+            EXPECT_TRUE(decoder.finish(&bin.back(), written));
+            EXPECT_EQ(written, 1u);
+            EXPECT_FALSE(decoder.pending());
+
+            EXPECT_EQ(bin, etalon);
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexStream_decoderBad)
+{
+    std::string hex(100, 'a');
+    hex[41] = 'x';
+
+    for(std::size_t chunk : {1u, 2u, 3u, 41u, 42u})
+    {
+        HexDecoder decoder;
+        std::vector<std::uint8_t> bin(hex.size());
+        bool ok = true;
+        for(std::size_t pos{}; ok && pos<hex.size(); pos += chunk)
+        {
+            std::size_t written;
+            ok = decoder.update(hex.data()+pos, std::min(chunk, hex.size()-pos), bin.data(), written);
+        }
+
+        EXPECT_FALSE(ok);
+        EXPECT_TRUE(decoder.failed());
+        EXPECT_EQ(decoder.badOffset(), 41u);
+
+        std::size_t written;
+        EXPECT_FALSE(decoder.update("00", 2, bin.data(), written));
+        decoder.reset();
+        EXPECT_TRUE(decoder.update("00", 2, bin.data(), written));
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexStream_big)
+{
+    EXPECT_THROW(HexEncoder{HexEndian::big}, std::invalid_argument);
+    EXPECT_THROW(HexDecoder{HexEndian::big}, std::invalid_argument);
+}
@@ -0,0 +1,156 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/hexdump.hpp>
+#include <sstream>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexdump)
+{
+    std::string data = "hello world, this is a hexdump";
+    data += std::string("\x00\x01\xff", 3);
+
+    EXPECT_EQ(hexdump(data.data(), data.size()),
+              "00000000  68 65 6c 6c 6f 20 77 6f  72 6c 64 2c 20 74 68 69  |hello world, thi|\n"
+              "00000010  73 20 69 73 20 61 20 68  65 78 64 75 6d 70 00 01  |s is a hexdump..|\n"
+              "00000020  ff                                                |.|\n"
+              "00000021\n");
+
+    HexdumpFormat format;
+    format._width = 6;
+    format._group = 4;
+    format._ascii = false;
+    format._offsetDigits = 2;
+    format._baseOffset = 0xfe;
+    EXPECT_EQ(hexdump(data.data(), 13, format),
+              "0fe  68 65 6c 6c  6f 20\n"
+              "104  77 6f 72 6c  64 2c\n"
+              "10a  20\n"
+              "10b\n");
+
+    EXPECT_EQ(hexdump(data.data(), 0), "");
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexdump_formats)
+{
+    std::vector<std::uint8_t> bin(1000);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*29 + 3);
+
+    // построчно, по одному байту
+    auto etalon = [&](std::size_t size, const HexdumpFormat& f)
+    {
+        const char* digits = "0123456789abcdef";
+        std::string res;
+        for(std::size_t pos{}; pos<size; pos += f._width)
+        {
+            char offset[16];
+            snprintf(offset, sizeof(offset), "%08zx", pos);
+            res += offset;
+            res += "  ";
+
+            std::string hex;
+            for(std::size_t i{}; i<f._width; ++i)
+            {
+                if(pos+i < size)
+                {
+                    hex += digits[bin[pos+i] >> 4];
+                    hex += digits[bin[pos+i] & 0x0f];
+                    hex += ' ';
+                }
+                else
+                    hex += "   ";
+
+                if(0 == (i+1) % f._group || i+1 == f._width)
+                    hex += ' ';
+            }
+
+            if(f._ascii)
+            {
+                res += hex;
+                res += '|';
+                for(std::size_t i{pos}; i<std::min(size, pos+f._width); ++i)
+                    res += (bin[i] >= 0x20 && bin[i] < 0x7f) ? static_cast<char>(bin[i]) : '.';
+                res += "|\n";
+            }
+            else
+            {
+                res += hex.substr(0, hex.find_last_not_of(' ')+1);
+                res += '\n';
+            }
+        }
+
+        if(size)
+        {
+            char offset[16];
+            snprintf(offset, sizeof(offset), "%08zx\n", size);
+            res += offset;
+        }
+
+        return res;
+    };
+
+    for(std::size_t width : {1u, 7u, 8u, 16u, 32u, 40u})
+    {
+        for(std::size_t group : {1u, 4u, 8u, 16u, 64u})
+        {
+            for(bool ascii : {true, false})
+            {
+                HexdumpFormat f;
+                f._width = width;
+                f._group = group;
+                f._ascii = ascii;
+
+                HexdumpFormat fe = f;
+                fe._group = std::min(group, width);
+
+                for(std::size_t size : {0u, 1u, 15u, 16u, 17u, 100u, 1000u})
+                {
+                    std::string str = hexdump(bin.data(), size, f);
+                    EXPECT_EQ(str.size(), hexdumpSize(size, f));
+                    EXPECT_EQ(str, etalon(size, fe));
+                }
+
+                std::ostringstream out;
+                hexdump(bin.data(), bin.size(), out, f);
+                EXPECT_EQ(out.str(), hexdump(bin.data(), bin.size(), f));
+            }
+        }
+    }
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, hexdump_zeroWidth)
+{
+    std::vector<std::uint8_t> bin(100);
+    for(std::size_t i{}; i<bin.size(); ++i)
+        bin[i] = static_cast<std::uint8_t>(i*13 + 5);
+
+    for(std::size_t group : {0u, 4u, 8u})
+    {
+        HexdumpFormat f;
+        f._width = 0;
+        f._group = group;
+
+        HexdumpFormat fe;
+        fe._group = group;
+
+        for(std::size_t size : {0u, 1u, 16u, 100u})
+        {
+            EXPECT_EQ(hexdumpSize(size, f), hexdumpSize(size, fe));
+            EXPECT_EQ(hexdump(bin.data(), size, f), hexdump(bin.data(), size, fe));
+        }
+
+        std::ostringstream out;
+        hexdump(bin.data(), bin.size(), out, f);
+        EXPECT_EQ(out.str(), hexdump(bin.data(), bin.size(), fe));
+    }
+}
@@ -0,0 +1,57 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/perfectHash.hpp>
+#include <string>
+#include <string_view>
+
+using namespace dci::utils;
+using namespace std::string_view_literals;
+
+namespace
+{
+    enum class Color {red, green, blue, none};
+
+    constexpr auto colors = perfectHash<Color>({
+        {"red",     Color::red},
+        {"green",   Color::green},
+        {"blue",    Color::blue},
+    });
+
+    static_assert(colors.value("green", Color::none) == Color::green);
+    static_assert(colors.value("gray", Color::none) == Color::none);
+    static_assert(colors.index("blue") == 2);
+    static_assert(colors.index("") == 3);
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, perfectHash)
+{
+    EXPECT_EQ(*colors.find(std::string{"red"}), Color::red);
+    EXPECT_EQ(colors.find("reds"), nullptr);
+    EXPECT_EQ(colors.find("Red"), nullptr);
+    EXPECT_EQ(colors.item(1).first, "green"sv);
+
+    constexpr auto words = perfectHash({
+        "a"sv, "b"sv, "c"sv, "ab"sv, "ba"sv, "abc"sv, "inproc"sv, "local"sv, "tcp"sv, "tcp4"sv, "tcp6"sv,
+        "udp"sv, "udp4"sv, "udp6"sv, "mailto"sv, "file"sv, "ftp"sv, "ftps"sv, "http"sv, "https"sv, "ws"sv, "wss"sv,
+    });
+    static_assert(words.size() == 22);
+
+    for(std::size_t i{}; i<words.size(); ++i)
+    {
+        std::string key{words.item(i).first};
+        EXPECT_EQ(words.index(key), i);
+        EXPECT_EQ(*words.find(key), i);
+
+        EXPECT_EQ(words.index(key + "x"), words.size());
+    }
+
+    for(std::string_view key : {""sv, "tcp5"sv, "HTTP"sv, "htt"sv, "bc"sv, "ws\0"sv})
+        EXPECT_EQ(words.find(key), nullptr);
+}
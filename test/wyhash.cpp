@@ -0,0 +1,85 @@
+/* This file is part of the the dci project. Copyright (C) 2013-2023 vopl, shtoba.
+   This program is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public
+   License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+   You should have received a copy of the GNU Affero General Public License along with this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <dci/test.hpp>
+#include <dci/utils/wyhash.hpp>
+#include <dci/utils/fnv1a.hpp>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include <iostream>
+
+using namespace dci::utils;
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+TEST(utils, wyhash)
+{
+    // эталонные значения wyhash final4, seed равен номеру строки
+    const std::pair<const char*, std::uint64_t> vectors[] =
+    {
+        {"",                                                                                    0x93228a4de0eec5a2},
+        {"a",                                                                                   0xc5bac3db178713c4},
+        {"abc",                                                                                 0xa97f2f7b1d9b3314},
+        {"message digest",                                                                      0x786d1f1df3801df4},
+        {"abcdefghijklmnopqrstuvwxyz",                                                          0xdca5a8138ad37c87},
+        {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",                      0xb9e734f117cfaf70},
+        {"12345678901234567890123456789012345678901234567890123456789012345678901234567890",    0x6cc5eab49a92d617},
+    };
+
+    for(std::size_t i{}; i<std::size(vectors); ++i)
+        EXPECT_EQ(wyhash(vectors[i].first, strlen(vectors[i].first), i), vectors[i].second);
+
+    static_assert(wyhash("abcdefghijklmnopqrstuvwxyz", 26, 4) == 0xdca5a8138ad37c87);
+    static_assert(wyhash("") == 0x93228a4de0eec5a2);
+
+    // константное и обычное вычисление совпадают на всех ветках по длине
+    constexpr auto ct = []
+    {
+        std::array<std::uint64_t, 120> res{};
+        char material[120]{};
+        for(std::size_t i{}; i<120; ++i)
+            material[i] = static_cast<char>(i*37 + 1);
+        for(std::size_t i{}; i<120; ++i)
+            res[i] = wyhash(material, i);
+        return res;
+    }();
+
+    std::string material;
+    for(std::size_t i{}; i<120; ++i)
+        material += static_cast<char>(i*37 + 1);
+    for(std::size_t i{}; i<120; ++i)
+        EXPECT_EQ(wyhash(material.data(), i), ct[i]);
+
+    EXPECT_EQ(wyhash(material), wyhash(material.data(), material.size()));
+    EXPECT_EQ(wyhash(std::vector<std::uint8_t>(material.begin(), material.end())), wyhash(material));
+}
+
+/////////0/////////1/////////2/////////3/////////4/////////5/////////6/////////7
+// сравнение скорости с fnv1a, запуск: --gtest_also_run_disabled_tests --gtest_filter=*wyhash_bench*
+TEST(utils, DISABLED_wyhash_bench)
+{
+    std::string material(64*1024, 'x');
+    for(std::size_t i{}; i<material.size(); ++i)
+        material[i] = static_cast<char>(i*131 + (i>>7));
+
+    auto measure = [&](std::size_t len, auto&& hash)
+    {
+        std::size_t rounds = std::max<std::size_t>(1, (64u<<20) / std::max<std::size_t>(len, 16));
+        return bench::measure(rounds, [&](std::size_t r){return hash(material.data() + (r*8) % (material.size() - len), len);});
+    };
+
+    for(std::size_t len : {4u, 8u, 16u, 32u, 64u, 256u, 1024u, 16384u})
+    {
+        double fnv = measure(len, [](const char* p, std::size_t n){return fnv1a(p, n);});
+        double wy  = measure(len, [](const char* p, std::size_t n){return wyhash(p, n);});
+
+        std::cout << "len " << len
+                  << ": fnv1a " << fnv << " ns (" << static_cast<double>(len) / fnv << " GB/s)"
+                  << ", wyhash " << wy << " ns (" << static_cast<double>(len) / wy << " GB/s)"
+                  << ", x" << fnv / wy << std::endl;
+    }
+}